@@ -0,0 +1,293 @@
+#ifndef HEXAGON_CONCURRENT_HEX_MAP_H
+#define HEXAGON_CONCURRENT_HEX_MAP_H
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+
+#include <hexagon.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup ConcurrentHexMap ConcurrentHexMap
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Hash map from Hexagon to T that can be read and written by many threads at
+ * once.
+ *  - Cells are inserted without locks (open addressing with linear probing,
+ *    slots are claimed with a compare-and-swap on the key).
+ *  - Single cell updates are atomic operations on std::atomic<T> (load,
+ *    store, fetch_add, compare_exchange).
+ *  - Compound updates spanning several cells are done under striped locks.
+ *    Each lock guards a \f$2^{RegionBits} \times 2^{RegionBits}\f$
+ *    parallelogram region of hexagons (hashed onto a fixed number of
+ *    mutexes), so threads working on separate parts of the map do not
+ *    contend.
+ * The capacity is fixed at construction, the map never rehashes and cells are
+ * never removed. The Hexagon(INT_MIN, INT_MIN) is reserved and can not be
+ * stored, inserting it throws std::invalid_argument. T must be trivially
+ * copyable (a requirement of std::atomic<T>).
+ ******************************************************************************/
+template<class T, int RegionBits = 4>
+class ConcurrentHexMap{
+public:
+        /*!*********************************************************************
+         * Create a map that can hold at least capacity cells, with
+         * lock_stripes mutexes for compound updates. Both numbers are rounded
+         * up to the closest power of two. Keep capacity well above the
+         * expected number of cells, probe sequences grow long when the table
+         * is nearly full.
+         **********************************************************************/
+        explicit ConcurrentHexMap(std::size_t capacity,
+                                  std::size_t lock_stripes = 64)
+         : capacity_(round_up_pow2(capacity)),
+           stripes_(round_up_pow2(lock_stripes)),
+           keys_(new std::atomic<std::uint64_t>[capacity_]),
+           values_(new std::atomic<T>[capacity_]),
+           locks_(new std::mutex[stripes_])
+        {
+                for(std::size_t i = 0; i < capacity_; i++){
+                        keys_[i].store(empty_key, std::memory_order_relaxed);
+                        values_[i].store(T{}, std::memory_order_relaxed);
+                }
+        }
+
+        /*!*********************************************************************
+         * Return the atomic cell stored at hex, inserting a cell holding T{}
+         * if there was none. Lock-free. Throws std::length_error if the map
+         * is full and std::invalid_argument for the reserved
+         * Hexagon(INT_MIN, INT_MIN).
+         **********************************************************************/
+        std::atomic<T>& cell(Hexagon hex)
+        {
+                const std::uint64_t key = pack(hex);
+                if(key == empty_key){
+                        throw std::invalid_argument(
+                                "ConcurrentHexMap: Hexagon(INT_MIN, INT_MIN) "
+                                "is reserved");
+                }
+                for(std::size_t probe = 0, i = slot(key); probe < capacity_;
+                    probe++, i = (i + 1) & (capacity_ - 1)){
+                        std::uint64_t current =
+                                keys_[i].load(std::memory_order_acquire);
+                        if(current == empty_key){
+                                if(keys_[i].compare_exchange_strong(
+                                        current, key,
+                                        std::memory_order_acq_rel)){
+                                        size_.fetch_add(
+                                                1, std::memory_order_relaxed);
+                                        return values_[i];
+                                }
+                        }
+                        // current now holds the key stored in the slot
+                        if(current == key){
+                                return values_[i];
+                        }
+                }
+                throw std::length_error("ConcurrentHexMap is full");
+        }
+
+        /*!*********************************************************************
+         * Return a pointer to the atomic cell stored at hex, or nullptr if
+         * there is none. Never inserts.
+         **********************************************************************/
+        const std::atomic<T>* find(Hexagon hex) const
+        {
+                const std::uint64_t key = pack(hex);
+                // The reserved key would match the first empty slot.
+                if(key == empty_key){
+                        return nullptr;
+                }
+                for(std::size_t probe = 0, i = slot(key); probe < capacity_;
+                    probe++, i = (i + 1) & (capacity_ - 1)){
+                        const std::uint64_t current =
+                                keys_[i].load(std::memory_order_acquire);
+                        if(current == key){
+                                return &values_[i];
+                        }
+                        if(current == empty_key){
+                                return nullptr;
+                        }
+                }
+                return nullptr;
+        }
+
+        std::atomic<T>* find(Hexagon hex)
+        {
+                const ConcurrentHexMap& self = *this;
+                return const_cast<std::atomic<T>*>(self.find(hex));
+        }
+
+        /*!*********************************************************************
+         * Return the value stored at hex, or T{} if there is none.
+         **********************************************************************/
+        T load(Hexagon hex) const
+        {
+                const std::atomic<T>* res = this->find(hex);
+                return res ? res->load() : T{};
+        }
+
+        void store(Hexagon hex, T value)
+        {
+                this->cell(hex).store(value);
+        }
+
+        /*!*********************************************************************
+         * Atomically add value to the cell at hex, inserting it if needed, and
+         * return the previous value. Works for any T with operator+ (also
+         * floating point types), using a compare-and-swap loop.
+         **********************************************************************/
+        T fetch_add(Hexagon hex, T value)
+        {
+                std::atomic<T>& c = this->cell(hex);
+                T expected = c.load(std::memory_order_relaxed);
+                while(!c.compare_exchange_weak(expected, expected + value)){}
+                return expected;
+        }
+
+        /*!*********************************************************************
+         * Atomically replace the value at hex by desired if it is equal to
+         * expected, inserting the cell if needed. On failure expected is
+         * updated to the current value.
+         **********************************************************************/
+        bool compare_exchange(Hexagon hex, T& expected, T desired)
+        {
+                return this->cell(hex).compare_exchange_strong(expected,
+                                                               desired);
+        }
+
+        /*!*********************************************************************
+         * Call f() while holding the lock guarding the region containing hex
+         * and return the result.
+         **********************************************************************/
+        template<class F>
+        auto with_lock(Hexagon hex, F f) -> decltype(f())
+        {
+                std::lock_guard<std::mutex> guard(locks_[stripe(hex)]);
+                return f();
+        }
+
+        /*!*********************************************************************
+         * Call f() while holding the locks guarding all regions containing any
+         * of the hexagons in hexes. Locks are always taken in the same order,
+         * so overlapping compound updates can not deadlock.
+         **********************************************************************/
+        template<class F>
+        auto with_locks(const std::vector<Hexagon>& hexes, F f) -> decltype(f())
+        {
+                std::vector<std::size_t> stripes(hexes.size());
+                std::transform(hexes.begin(), hexes.end(), stripes.begin(),
+                               [this](Hexagon hex)
+                               {
+                                       return this->stripe(hex);
+                               });
+                std::sort(stripes.begin(), stripes.end());
+                stripes.erase(std::unique(stripes.begin(), stripes.end()),
+                              stripes.end());
+                std::vector<std::unique_lock<std::mutex>> guards;
+                guards.reserve(stripes.size());
+                for(const auto s : stripes){
+                        guards.emplace_back(locks_[s]);
+                }
+                return f();
+        }
+
+        /*!*********************************************************************
+         * Call f(hex, value) for every stored cell. Cells inserted while
+         * iterating may or may not be visited.
+         **********************************************************************/
+        template<class F>
+        void for_each(F f) const
+        {
+                for(std::size_t i = 0; i < capacity_; i++){
+                        const std::uint64_t key =
+                                keys_[i].load(std::memory_order_acquire);
+                        if(key != empty_key){
+                                f(unpack(key), values_[i].load());
+                        }
+                }
+        }
+
+        /*!*********************************************************************
+         * Return the number of stored cells.
+         **********************************************************************/
+        std::size_t size() const
+        {
+                return size_.load();
+        }
+
+        std::size_t capacity() const
+        {
+                return capacity_;
+        }
+
+private:
+        static constexpr std::uint64_t empty_key =
+                0x8000000080000000ull; // Hexagon(INT_MIN, INT_MIN)
+
+        std::size_t capacity_, stripes_;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> keys_;
+        std::unique_ptr<std::atomic<T>[]> values_;
+        std::unique_ptr<std::mutex[]> locks_;
+        std::atomic<std::size_t> size_{0};
+
+        static std::size_t round_up_pow2(std::size_t n)
+        {
+                std::size_t res = 1;
+                while(res < n){
+                        res <<= 1;
+                }
+                return res;
+        }
+
+        static std::uint64_t pack(Hexagon hex)
+        {
+                return (static_cast<std::uint64_t>(
+                                static_cast<std::uint32_t>(hex.a)) << 32) |
+                        static_cast<std::uint32_t>(hex.b);
+        }
+
+        static Hexagon unpack(std::uint64_t key)
+        {
+                return {static_cast<std::int32_t>(key >> 32),
+                        static_cast<std::int32_t>(key & 0xffffffffu)};
+        }
+
+        /*!*********************************************************************
+         * Mix the bits of key (the splitmix64 finalizer), neighbouring
+         * hexagons would otherwise end up in neighbouring slots.
+         **********************************************************************/
+        static std::uint64_t mix(std::uint64_t key)
+        {
+                key ^= key >> 30;
+                key *= 0xbf58476d1ce4e5b9ull;
+                key ^= key >> 27;
+                key *= 0x94d049bb133111ebull;
+                return key ^ (key >> 31);
+        }
+
+        std::size_t slot(std::uint64_t key) const
+        {
+                return mix(key) & (capacity_ - 1);
+        }
+
+        std::size_t stripe(Hexagon hex) const
+        {
+                const Hexagon region{hex.a >> RegionBits, hex.b >> RegionBits};
+                return mix(pack(region)) & (stripes_ - 1);
+        }
+};
+
+template<class T, int RegionBits>
+constexpr std::uint64_t ConcurrentHexMap<T, RegionBits>::empty_key;
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_CONCURRENT_HEX_MAP_H
@@ -0,0 +1,257 @@
+#ifndef HEXAGON_CONTOUR_H
+#define HEXAGON_CONTOUR_H
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <point.h>
+#include <hexagon.h>
+#include <hex_field.h>
+#include <polyline.h>
+#include <parallel.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Contour Contour
+ * Contour lines (isolines) of per-hexagon scalar fields, by marching
+ * triangles. The hexagon centers of a HexField are triangulated by the
+ * triangles of three mutually neighbouring hexagons (the dual of
+ * Hexagon::wedges()), two per lattice cell: (a, b), (a + 1, b),
+ * (a + 1, b + 1) and (a, b), (a + 1, b + 1), (a, b + 1), both
+ * counter-clockwise.
+ * Contour vertices lie on the lattice edges between neighbouring centers and
+ * are identified by the edge (3 per hexagon, towards neighbor_directions 0, 1
+ * and 2), so segments from different triangles and tiles are joined by
+ * integer ids and every vertex is computed exactly once per polyline.
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * The contour lines of a field at one level. Lines are oriented with the
+ * region at or above the level on the left, so closed lines run
+ * counter-clockwise around maxima. Lines ending at the border of the field
+ * (or at NaN values) are open.
+ ******************************************************************************/
+struct Contour{
+        double level = 0;
+        std::vector<Polyline> polylines;
+};
+
+namespace detail{
+/*!*****************************************************************************
+ * A contour segment from the vertex on lattice edge first to the one on
+ * lattice edge second.
+ ******************************************************************************/
+using ContourSegment = std::pair<std::size_t, std::size_t>;
+
+/*!*****************************************************************************
+ * Return the point where the value interpolated along lattice edge id
+ * crosses level.
+ ******************************************************************************/
+template<class T>
+Point contour_vertex(const HexField<T>& field, std::size_t id, double level)
+{
+        const Hexagon from = field.hex(id/3);
+        const Hexagon to = from + neighbor_directions[id % 3];
+        const double v0 = static_cast<double>(field[from]);
+        const double v1 = static_cast<double>(field[to]);
+        const Point p0 = from.to_point(), p1 = to.to_point();
+        return p0 + (p1 - p0)*((level - v0)/(v1 - v0));
+}
+
+/*!*****************************************************************************
+ * Add the segments of the triangle with (counter-clockwise) values values
+ * and edge ids edges (edges[j] joins corner j and j + 1) for every level in
+ * sorted_levels it crosses, to segments[level index].
+ ******************************************************************************/
+inline void march_triangle(const std::array<double, 3>& values,
+                           const std::array<std::size_t, 3>& edges,
+                           const std::vector<std::pair<double, std::size_t>>&
+                                   sorted_levels,
+                           std::vector<std::vector<ContourSegment>>& segments)
+{
+        if(std::isnan(values[0]) || std::isnan(values[1]) ||
+           std::isnan(values[2])){
+                return;
+        }
+        const auto range = std::minmax_element(values.begin(), values.end());
+        // Crossed levels: min < level <= max
+        const auto compare = [](double v, const std::pair<double, std::size_t>& l)
+                             {
+                                     return v < l.first;
+                             };
+        const auto first = std::upper_bound(sorted_levels.begin(),
+                                            sorted_levels.end(), *range.first,
+                                            compare);
+        const auto last = std::upper_bound(first, sorted_levels.end(),
+                                           *range.second, compare);
+        for(auto level = first; level != last; ++level){
+                int exit = 0, enter = 0;
+                for(int j = 0; j < 3; j++){
+                        const bool from = values[j] >= level->first;
+                        const bool to = values[(j + 1) % 3] >= level->first;
+                        if(from && !to){
+                                exit = j;
+                        }else if(!from && to){
+                                enter = j;
+                        }
+                }
+                segments[level->second].push_back({edges[exit], edges[enter]});
+        }
+}
+
+/*!*****************************************************************************
+ * Join the segments of one level into polylines. Chains starting at a vertex
+ * no segment ends at are open, the remaining segments form closed loops.
+ ******************************************************************************/
+template<class T>
+std::vector<Polyline> stitch(const HexField<T>& field,
+                             const std::vector<ContourSegment>& segments,
+                             double level)
+{
+        std::unordered_map<std::size_t, std::size_t> next;
+        std::unordered_set<std::size_t> ends;
+        next.reserve(segments.size());
+        ends.reserve(segments.size());
+        for(const auto& segment : segments){
+                next.emplace(segment.first, segment.second);
+                ends.insert(segment.second);
+        }
+        std::vector<Polyline> res;
+        const auto walk = [&](std::size_t start, bool closed)
+                          {
+                                  Polyline line;
+                                  line.closed = closed;
+                                  line.points.push_back(
+                                          contour_vertex(field, start, level));
+                                  for(std::size_t id = start;;){
+                                          const auto it = next.find(id);
+                                          if(it == next.end()){
+                                                  break;
+                                          }
+                                          id = it->second;
+                                          next.erase(it);
+                                          if(id == start){
+                                                  break;
+                                          }
+                                          // Vertices on different edges
+                                          // coincide where the line passes
+                                          // through a center with a value
+                                          // equal to the level.
+                                          const Point p =
+                                                  contour_vertex(field, id, level);
+                                          if(p != line.points.back()){
+                                                  line.points.push_back(p);
+                                          }
+                                  }
+                                  if(closed && line.points.size() > 1 &&
+                                     line.points.back() == line.points.front()){
+                                          line.points.pop_back();
+                                  }
+                                  res.push_back(std::move(line));
+                          };
+        for(const auto& segment : segments){
+                if(!ends.count(segment.first) && next.count(segment.first)){
+                        walk(segment.first, false);
+                }
+        }
+        for(const auto& segment : segments){
+                if(next.count(segment.first)){
+                        walk(segment.first, true);
+                }
+        }
+        return res;
+}
+}
+
+/*!*****************************************************************************
+ * Return the contour lines of field at each of levels, in the order of
+ * levels. All levels are extracted in one pass over the triangulation, each
+ * triangle only visiting the levels between its smallest and largest value.
+ * The field is split into tiles of tile_size x tile_size cells marched in
+ * parallel on num_threads threads (0 means one per hardware thread), the
+ * segments of each level are then stitched across tiles (levels in
+ * parallel). Triangles with a NaN value are skipped. Throws
+ * std::invalid_argument if tile_size is not positive.
+ ******************************************************************************/
+template<class T>
+std::vector<Contour> contours(const HexField<T>& field,
+                              const std::vector<double>& levels,
+                              unsigned num_threads = 0, int tile_size = 64)
+{
+        if(tile_size <= 0){
+                throw std::invalid_argument("contours: tile_size must be positive");
+        }
+        std::vector<std::pair<double, std::size_t>> sorted_levels;
+        for(std::size_t i = 0; i < levels.size(); i++){
+                sorted_levels.push_back({levels[i], i});
+        }
+        std::sort(sorted_levels.begin(), sorted_levels.end());
+
+        const int width = field.width(), height = field.height();
+        const int tiles_a = std::max(0, (width - 1 + tile_size - 1)/tile_size);
+        const int tiles_b = std::max(0, (height - 1 + tile_size - 1)/tile_size);
+        const std::size_t num_tiles = static_cast<std::size_t>(tiles_a)*tiles_b;
+        // segments[tile][level]
+        std::vector<std::vector<std::vector<detail::ContourSegment>>>
+                segments(num_tiles, std::vector<std::vector<detail::ContourSegment>>(
+                        levels.size()));
+        const auto& values = field.values();
+        parallel_for(num_tiles, num_threads, [&](std::size_t tile)
+        {
+                const int a_begin = static_cast<int>(tile % tiles_a)*tile_size;
+                const int b_begin = static_cast<int>(tile / tiles_a)*tile_size;
+                const int a_end = std::min(a_begin + tile_size, width - 1);
+                const int b_end = std::min(b_begin + tile_size, height - 1);
+                for(int b = b_begin; b < b_end; b++){
+                        for(int a = a_begin; a < a_end; a++){
+                                // Storage indices of (a, b), (a + 1, b),
+                                // (a + 1, b + 1) and (a, b + 1)
+                                const std::size_t i00 = a + static_cast<std::size_t>(width)*b;
+                                const std::size_t i10 = i00 + 1;
+                                const std::size_t i11 = i00 + width + 1;
+                                const std::size_t i01 = i00 + width;
+                                const double v00 = static_cast<double>(values[i00]);
+                                const double v10 = static_cast<double>(values[i10]);
+                                const double v11 = static_cast<double>(values[i11]);
+                                const double v01 = static_cast<double>(values[i01]);
+                                detail::march_triangle({v00, v10, v11},
+                                                       {3*i00, 3*i10 + 2, 3*i00 + 1},
+                                                       sorted_levels, segments[tile]);
+                                detail::march_triangle({v00, v11, v01},
+                                                       {3*i00 + 1, 3*i01, 3*i00 + 2},
+                                                       sorted_levels, segments[tile]);
+                        }
+                }
+        });
+
+        std::vector<Contour> res(levels.size());
+        parallel_for(levels.size(), num_threads, [&](std::size_t level)
+        {
+                std::vector<detail::ContourSegment> all;
+                for(const auto& tile : segments){
+                        all.insert(all.end(), tile[level].begin(),
+                                   tile[level].end());
+                }
+                res[level].level = levels[level];
+                res[level].polylines = detail::stitch(field, all, levels[level]);
+        });
+        return res;
+}
+
+template<class T>
+Contour contour(const HexField<T>& field, double level,
+                unsigned num_threads = 0)
+{
+        return contours(field, std::vector<double>{level}, num_threads).front();
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_CONTOUR_H
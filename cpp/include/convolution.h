@@ -0,0 +1,191 @@
+#ifndef HEXAGON_CONVOLUTION_H
+#define HEXAGON_CONVOLUTION_H
+
+#include <vector>
+#include <complex>
+#include <utility>
+#include <stdexcept>
+
+#include <hexagon.h>
+#include <hex_field.h>
+#include <fft.h>
+#include <parallel.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Convolution Convolution
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Convolution kernel over the hexagons within radius steps of the origin,
+ * i.e. the cells of spiral(Hexagon{0, 0}, radius).
+ ******************************************************************************/
+struct HexKernel{
+        int radius = 0;
+        /*!*********************************************************************
+         * Weights of all offsets in the (2 radius + 1)^2 parallelogram around
+         * the origin, offset (a, b) is stored at
+         * (a + radius) + (2 radius + 1)(b + radius). Offsets further than
+         * radius steps away are zero.
+         **********************************************************************/
+        std::vector<double> weights;
+
+        /*!*********************************************************************
+         * Return the kernel with weight f(offset) for every offset within
+         * radius steps of the origin.
+         **********************************************************************/
+        template<class F>
+        static HexKernel from_function(int radius, F f)
+        {
+                HexKernel res{radius,
+                              std::vector<double>((2*radius + 1)*(2*radius + 1))};
+                for(const auto& offset : spiral(Hexagon{0, 0}, radius)){
+                        res.weights[res.index(offset)] = f(offset);
+                }
+                return res;
+        }
+
+        double operator()(Hexagon offset) const
+        {
+                if(manhattan_distance(offset) > radius){
+                        return 0;
+                }
+                return weights[index(offset)];
+        }
+
+private:
+        std::size_t index(Hexagon offset) const
+        {
+                return static_cast<std::size_t>(offset.a + radius) +
+                       static_cast<std::size_t>(2*radius + 1)*
+                       (offset.b + radius);
+        }
+};
+
+enum class ConvolutionMethod{
+        /*!*********************************************************************
+         * direct for kernels with radius below fft_radius_threshold, fft
+         * otherwise.
+         **********************************************************************/
+        automatic,
+        /*!*********************************************************************
+         * Sum over the kernel offsets for every cell, \f$O(N r^2)\f$.
+         **********************************************************************/
+        direct,
+        /*!*********************************************************************
+         * Pointwise product of hex_fft transforms of the zero padded field
+         * and kernel, \f$O(N \log N)\f$.
+         **********************************************************************/
+        fft
+};
+
+/*!*****************************************************************************
+ * Kernel radius from which ConvolutionMethod::automatic uses the FFT.
+ ******************************************************************************/
+constexpr int fft_radius_threshold = 16;
+
+/*!*****************************************************************************
+ * Return the convolution of field with kernel,
+ * \f$ out(h) = \sum_{o} kernel(o) field(h - o) \f$, with the field taken as
+ * zero outside its parallelogram. The result has the same origin, size and
+ * cell ordering as field. Throws std::invalid_argument for a kernel with a
+ * negative radius or without (2 radius + 1)^2 weights.
+ ******************************************************************************/
+template<class T>
+HexField<double> convolve(const HexField<T>& field, const HexKernel& kernel,
+                          ConvolutionMethod method = ConvolutionMethod::automatic,
+                          unsigned num_threads = 0)
+{
+        const int width = field.width(), height = field.height();
+        const int r = kernel.radius;
+        // Checked before any work is handed to threads, where an exception
+        // would terminate.
+        if(r < 0){
+                throw std::invalid_argument("convolve: negative kernel radius");
+        }
+        // Both methods read the kernel through operator(), which indexes
+        // weights without bounds checks.
+        const std::size_t side = 2*static_cast<std::size_t>(r) + 1;
+        if(kernel.weights.size() != side*side){
+                throw std::invalid_argument(
+                        "convolve: kernel needs (2 radius + 1)^2 weights");
+        }
+        HexField<double> res(field.origin(), width, height);
+        if(res.size() == 0){
+                return res;
+        }
+        if(method == ConvolutionMethod::automatic){
+                method = r < fft_radius_threshold ? ConvolutionMethod::direct :
+                                                    ConvolutionMethod::fft;
+        }
+
+        if(method == ConvolutionMethod::direct){
+                std::vector<std::pair<Hexagon, double>> taps;
+                for(const auto& offset : spiral(Hexagon{0, 0}, r)){
+                        if(kernel(offset) != 0){
+                                taps.push_back({offset, kernel(offset)});
+                        }
+                }
+                const auto& in = field.values();
+                auto& out = res.values();
+                parallel_for(height, num_threads, [&](std::size_t row)
+                {
+                        const int b = static_cast<int>(row);
+                        for(int a = 0; a < width; a++){
+                                double sum = 0;
+                                for(const auto& tap : taps){
+                                        const int sa = a - tap.first.a;
+                                        const int sb = b - tap.first.b;
+                                        if(sa >= 0 && sa < width &&
+                                           sb >= 0 && sb < height){
+                                                sum += tap.second*static_cast<double>(
+                                                        in[sa + static_cast<std::size_t>(width)*sb]);
+                                        }
+                                }
+                                out[a + static_cast<std::size_t>(width)*b] = sum;
+                        }
+                });
+                return res;
+        }
+
+        // Zero padding by the kernel radius keeps the periodic convolution
+        // from wrapping values around into the field.
+        const int padded_width = static_cast<int>(next_power_of_two(width + r));
+        const int padded_height = static_cast<int>(next_power_of_two(height + r));
+        HexField<std::complex<double>> f(Hexagon{0, 0}, padded_width,
+                                         padded_height);
+        HexField<std::complex<double>> k(Hexagon{0, 0}, padded_width,
+                                         padded_height);
+        for(int b = 0; b < height; b++){
+                for(int a = 0; a < width; a++){
+                        f[Hexagon{a, b}] = static_cast<double>(
+                                field.values()[a + static_cast<std::size_t>(width)*b]);
+                }
+        }
+        for(const auto& offset : spiral(Hexagon{0, 0}, r)){
+                k[Hexagon{(offset.a + padded_width) % padded_width,
+                          (offset.b + padded_height) % padded_height}] =
+                        kernel(offset);
+        }
+        hex_fft(f, false, num_threads);
+        hex_fft(k, false, num_threads);
+        auto& fv = f.values();
+        const auto& kv = k.values();
+        parallel_for(fv.size(), num_threads, [&](std::size_t i)
+        {
+                fv[i] *= kv[i];
+        });
+        hex_fft(f, true, num_threads);
+        for(int b = 0; b < height; b++){
+                for(int a = 0; a < width; a++){
+                        res.values()[a + static_cast<std::size_t>(width)*b] =
+                                f[Hexagon{a, b}].real();
+                }
+        }
+        return res;
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_CONVOLUTION_H
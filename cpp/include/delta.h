@@ -0,0 +1,257 @@
+#ifndef HEXAGON_DELTA_H
+#define HEXAGON_DELTA_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include <hexagon.h>
+#include <hex_world.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Delta Delta
+ * Compact binary encoding of the changes to a HexWorld, for keeping replicas
+ * in sync. A delta is
+ *  - varint base epoch, varint epoch, one flag byte (bit 0: reset),
+ *  - runs of horizontally consecutive cells: varint length (> 0), zigzag
+ *    varint a and b of the first cell relative to the cell after the
+ *    previous run, then length values of T as raw bytes,
+ *  - varint 0.
+ *
+ * Varints are little endian base 128. Values are copied as they are in
+ * memory, so T must be trivially copyable and both ends must agree on its
+ * layout.
+ * @{
+ ******************************************************************************/
+struct DeltaHeader{
+        /*!*********************************************************************
+         * Epoch the changes apply on top of.
+         **********************************************************************/
+        std::uint64_t base_epoch = 0;
+        /*!*********************************************************************
+         * Epoch of the world once the changes are applied.
+         **********************************************************************/
+        std::uint64_t epoch = 0;
+        /*!*********************************************************************
+         * If set, all cells are to be removed before applying the runs.
+         **********************************************************************/
+        bool reset = false;
+};
+
+namespace detail{
+class DeltaWriter{
+public:
+        explicit DeltaWriter(std::size_t value_size)
+         : value_size_(value_size)
+        {}
+
+        void header(const DeltaHeader& header)
+        {
+                varint(header.base_epoch);
+                varint(header.epoch);
+                bytes_.push_back(header.reset ? 1 : 0);
+        }
+
+        /*!*********************************************************************
+         * Add the cell hex, starting a new run unless it directly follows the
+         * last cell added.
+         **********************************************************************/
+        void cell(Hexagon hex, const void* value)
+        {
+                if(length_ == 0 || hex != next_){
+                        flush();
+                        run_start_ = hex;
+                }
+                const auto* p = static_cast<const std::uint8_t*>(value);
+                values_.insert(values_.end(), p, p + value_size_);
+                length_++;
+                next_ = hex + Hexagon{1, 0};
+        }
+
+        std::vector<std::uint8_t> finish()
+        {
+                flush();
+                varint(0);
+                return std::move(bytes_);
+        }
+
+private:
+        std::size_t value_size_;
+        std::vector<std::uint8_t> bytes_, values_;
+        std::uint64_t length_ = 0;
+        Hexagon run_start_, next_, cursor_;
+
+        void varint(std::uint64_t value)
+        {
+                while(value >= 0x80){
+                        bytes_.push_back(static_cast<std::uint8_t>(value | 0x80));
+                        value >>= 7;
+                }
+                bytes_.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        void zigzag(std::int64_t value)
+        {
+                varint((static_cast<std::uint64_t>(value) << 1) ^
+                       static_cast<std::uint64_t>(value >> 63));
+        }
+
+        void flush()
+        {
+                if(length_ == 0){
+                        return;
+                }
+                varint(length_);
+                zigzag(static_cast<std::int64_t>(run_start_.a) - cursor_.a);
+                zigzag(static_cast<std::int64_t>(run_start_.b) - cursor_.b);
+                bytes_.insert(bytes_.end(), values_.begin(), values_.end());
+                values_.clear();
+                cursor_ = next_;
+                length_ = 0;
+        }
+};
+
+class DeltaReader{
+public:
+        DeltaReader(const std::uint8_t* data, std::size_t size)
+         : data_(data), end_(data + size)
+        {}
+
+        std::uint64_t varint()
+        {
+                std::uint64_t res = 0;
+                for(int shift = 0; shift < 64; shift += 7){
+                        const std::uint8_t byte = *take(1);
+                        res |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                        if(!(byte & 0x80)){
+                                return res;
+                        }
+                }
+                throw std::invalid_argument("delta: varint too long");
+        }
+
+        std::int64_t zigzag()
+        {
+                const std::uint64_t value = varint();
+                return static_cast<std::int64_t>(value >> 1) ^
+                       -static_cast<std::int64_t>(value & 1);
+        }
+
+        const std::uint8_t* take(std::size_t n)
+        {
+                if(static_cast<std::size_t>(end_ - data_) < n){
+                        throw std::invalid_argument("delta: truncated input");
+                }
+                const std::uint8_t* res = data_;
+                data_ += n;
+                return res;
+        }
+
+        bool done() const
+        {
+                return data_ == end_;
+        }
+
+private:
+        const std::uint8_t* data_;
+        const std::uint8_t* end_;
+};
+}
+
+/*!*****************************************************************************
+ * Return the changes to world since its last snapshot(), then take a new
+ * snapshot. Runs in time proportional to the number of dirty chunks; the
+ * size of the output is proportional to the number of changed cells.
+ ******************************************************************************/
+template<class T, int ChunkBits>
+std::vector<std::uint8_t> encode_delta(HexWorld<T, ChunkBits>& world)
+{
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "encode_delta: T must be trivially copyable");
+        detail::DeltaWriter writer(sizeof(T));
+        writer.header(DeltaHeader{world.epoch(), world.epoch() + 1,
+                                  world.cleared()});
+        world.for_each_dirty([&writer](Hexagon hex, const T& value)
+                             {
+                                     writer.cell(hex, &value);
+                             });
+        world.snapshot();
+        return writer.finish();
+}
+
+/*!*****************************************************************************
+ * Return all cells of world as a delta with the reset flag set, for bringing
+ * a new (or out of sync) replica up to world.epoch(). Does not touch the
+ * dirty state of world.
+ ******************************************************************************/
+template<class T, int ChunkBits>
+std::vector<std::uint8_t> encode_full(const HexWorld<T, ChunkBits>& world)
+{
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "encode_full: T must be trivially copyable");
+        detail::DeltaWriter writer(sizeof(T));
+        writer.header(DeltaHeader{world.epoch(), world.epoch(), true});
+        world.for_each([&writer](Hexagon hex, const T& value)
+                       {
+                               writer.cell(hex, &value);
+                       });
+        return writer.finish();
+}
+
+/*!*****************************************************************************
+ * Write the cells of the delta in data[0, size) to world, clearing it first
+ * if the reset flag is set, and return the header. It is up to the caller to
+ * check that base_epoch matches the state of world (or reset is set). The
+ * written cells are marked dirty in world like any other write.
+ * Throws std::invalid_argument if the input is malformed; cells decoded
+ * before the error have been written.
+ ******************************************************************************/
+template<class T, int ChunkBits>
+DeltaHeader apply_delta(HexWorld<T, ChunkBits>& world, const std::uint8_t* data,
+                        std::size_t size)
+{
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "apply_delta: T must be trivially copyable");
+        detail::DeltaReader reader(data, size);
+        DeltaHeader header;
+        header.base_epoch = reader.varint();
+        header.epoch = reader.varint();
+        header.reset = *reader.take(1) & 1;
+        if(header.reset){
+                world.clear();
+        }
+        std::int64_t a = 0, b = 0;
+        for(std::uint64_t length = reader.varint(); length > 0;
+            length = reader.varint()){
+                a += reader.zigzag();
+                b += reader.zigzag();
+                if(length > size/sizeof(T)){
+                        throw std::invalid_argument("delta: truncated input");
+                }
+                const std::uint8_t* values = reader.take(length*sizeof(T));
+                for(std::uint64_t i = 0; i < length; i++, a++){
+                        std::memcpy(&world[Hexagon{static_cast<int>(a),
+                                                   static_cast<int>(b)}],
+                                    values + i*sizeof(T), sizeof(T));
+                }
+        }
+        if(!reader.done()){
+                throw std::invalid_argument("delta: trailing data");
+        }
+        return header;
+}
+
+template<class T, int ChunkBits>
+DeltaHeader apply_delta(HexWorld<T, ChunkBits>& world,
+                        const std::vector<std::uint8_t>& delta)
+{
+        return apply_delta(world, delta.data(), delta.size());
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_DELTA_H
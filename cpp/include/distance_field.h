@@ -0,0 +1,187 @@
+#ifndef HEXAGON_DISTANCE_FIELD_H
+#define HEXAGON_DISTANCE_FIELD_H
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include <hexagon.h>
+#include <hex_field.h>
+#include <parallel.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup DistanceField DistanceField
+ * @{
+ ******************************************************************************/
+namespace detail{
+/*!*****************************************************************************
+ * Return, for every cell of features, the storage index of the closest
+ * feature cell (a cell whose value converts to true) according to metric, or
+ * -1 if there are no features. metric(offset) must be monotone in the
+ * hexagonal step distance along straight lines.
+ * The nearest feature is propagated in two raster sweeps (a chamfer
+ * transform carrying the feature location): a forward sweep pulling from the
+ * (-1, 0), (0, -1) and (-1, -1) neighbours and a backward sweep pulling from
+ * the opposite ones. Shortest hexagonal paths can always be made monotone in
+ * both a and b, so the two sweeps are exact for the manhattan_distance.
+ * The field is split into tile_size x tile_size tiles. A tile only depends on
+ * the tiles before it in a and b, so all tiles on the same anti-diagonal are
+ * swept in parallel.
+ ******************************************************************************/
+template<class Feature, class Metric>
+std::vector<long> nearest_features(const HexField<Feature>& features,
+                                   Metric metric, unsigned num_threads,
+                                   int tile_size = 64)
+{
+        const int width = features.width(), height = features.height();
+        std::vector<long> nearest(features.size(), -1);
+        std::vector<long long> distance(features.size(),
+                                        std::numeric_limits<long long>::max());
+        for(std::size_t i = 0; i < features.size(); i++){
+                if(static_cast<bool>(features.values()[i])){
+                        nearest[i] = static_cast<long>(i);
+                        distance[i] = 0;
+                }
+        }
+
+        const auto relax = [&](int a, int b, int da, int db)
+        {
+                const int na = a + da, nb = b + db;
+                if(na < 0 || na >= width || nb < 0 || nb >= height){
+                        return;
+                }
+                const long candidate = nearest[na + static_cast<long>(width)*nb];
+                if(candidate < 0){
+                        return;
+                }
+                const long i = a + static_cast<long>(width)*b;
+                const long long d = metric(
+                        Hexagon{a - static_cast<int>(candidate % width),
+                                b - static_cast<int>(candidate / width)});
+                if(d < distance[i]){
+                        distance[i] = d;
+                        nearest[i] = candidate;
+                }
+        };
+        const auto forward = [&](int ta, int tb)
+        {
+                const int a_end = std::min(width, (ta + 1)*tile_size);
+                const int b_end = std::min(height, (tb + 1)*tile_size);
+                for(int b = tb*tile_size; b < b_end; b++){
+                        for(int a = ta*tile_size; a < a_end; a++){
+                                relax(a, b, -1, 0);
+                                relax(a, b, 0, -1);
+                                relax(a, b, -1, -1);
+                        }
+                }
+        };
+        const auto backward = [&](int ta, int tb)
+        {
+                const int a_begin = ta*tile_size, b_begin = tb*tile_size;
+                for(int b = std::min(height, (tb + 1)*tile_size) - 1;
+                    b >= b_begin; b--){
+                        for(int a = std::min(width, (ta + 1)*tile_size) - 1;
+                            a >= a_begin; a--){
+                                relax(a, b, 1, 0);
+                                relax(a, b, 0, 1);
+                                relax(a, b, 1, 1);
+                        }
+                }
+        };
+
+        const int tiles_a = (width + tile_size - 1)/tile_size;
+        const int tiles_b = (height + tile_size - 1)/tile_size;
+        const auto sweep_diagonal = [&](int diagonal, bool is_forward)
+        {
+                const int ta_begin = std::max(0, diagonal - tiles_b + 1);
+                const int ta_end = std::min(tiles_a, diagonal + 1);
+                parallel_for(static_cast<std::size_t>(
+                                std::max(0, ta_end - ta_begin)), num_threads,
+                             [&](std::size_t i)
+                             {
+                                     const int ta = ta_begin + static_cast<int>(i);
+                                     if(is_forward){
+                                             forward(ta, diagonal - ta);
+                                     }else{
+                                             backward(ta, diagonal - ta);
+                                     }
+                             });
+        };
+        for(int diagonal = 0; diagonal < tiles_a + tiles_b - 1; diagonal++){
+                sweep_diagonal(diagonal, true);
+        }
+        for(int diagonal = tiles_a + tiles_b - 2; diagonal >= 0; diagonal--){
+                sweep_diagonal(diagonal, false);
+        }
+        return nearest;
+}
+}
+
+/*!*****************************************************************************
+ * Return the exact manhattan_distance from every cell of features to the
+ * closest feature cell (a cell whose value converts to true). The result has
+ * the same origin, size and cell ordering as features. Cells get
+ * std::numeric_limits<int>::max() if there are no features at all.
+ ******************************************************************************/
+template<class Feature>
+HexField<int> distance_transform(const HexField<Feature>& features,
+                                 unsigned num_threads = 0)
+{
+        const auto nearest = detail::nearest_features(
+                features,
+                [](Hexagon offset) -> long long
+                {
+                        return manhattan_distance(offset);
+                },
+                num_threads);
+        HexField<int> res(features.origin(), features.width(),
+                          features.height(), std::numeric_limits<int>::max());
+        for(std::size_t i = 0; i < res.size(); i++){
+                if(nearest[i] >= 0){
+                        res.values()[i] = manhattan_distance(
+                                features.hex(i) - features.hex(nearest[i]));
+                }
+        }
+        return res;
+}
+
+/*!*****************************************************************************
+ * Return the approximate euclidean_distance (between hexagon centers) from
+ * every cell of features to the closest feature cell. The nearest feature is
+ * propagated between neighbouring cells, so in rare configurations a
+ * slightly more distant feature is reported. The result has the same origin,
+ * size and cell ordering as features. Cells get infinity if there are no
+ * features at all.
+ ******************************************************************************/
+template<class Feature>
+HexField<double> euclidean_distance_transform(const HexField<Feature>& features,
+                                              unsigned num_threads = 0)
+{
+        const auto nearest = detail::nearest_features(
+                features,
+                [](Hexagon offset) -> long long
+                {
+                        // Squared euclidean distance, exact in integers.
+                        return static_cast<long long>(offset.a)*offset.a +
+                               static_cast<long long>(offset.b)*offset.b -
+                               static_cast<long long>(offset.a)*offset.b;
+                },
+                num_threads);
+        HexField<double> res(features.origin(), features.width(),
+                             features.height(),
+                             std::numeric_limits<double>::infinity());
+        for(std::size_t i = 0; i < res.size(); i++){
+                if(nearest[i] >= 0){
+                        res.values()[i] = euclidean_distance(
+                                features.hex(i) - features.hex(nearest[i]));
+                }
+        }
+        return res;
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_DISTANCE_FIELD_H
@@ -0,0 +1,142 @@
+#ifndef HEXAGON_FFT_H
+#define HEXAGON_FFT_H
+
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <utility>
+#include <stdexcept>
+
+#include <hex_field.h>
+#include <parallel.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup FFT FFT
+ * @{
+ ******************************************************************************/
+inline bool is_power_of_two(std::size_t n)
+{
+        return n > 0 && (n & (n - 1)) == 0;
+}
+
+/*!*****************************************************************************
+ * Return the smallest power of two not less than n.
+ ******************************************************************************/
+inline std::size_t next_power_of_two(std::size_t n)
+{
+        std::size_t res = 1;
+        while(res < n){
+                res <<= 1;
+        }
+        return res;
+}
+
+/*!*****************************************************************************
+ * In place radix-2 fast Fourier transform of the n values data[0],
+ * data[stride], ..., data[(n - 1)*stride]. n must be a power of two. The
+ * forward transform uses \f$ e^{-2\pi i jk/n} \f$, the inverse transform
+ * \f$ e^{2\pi i jk/n} \f$ and divides by n, so that they are each other's
+ * inverses.
+ ******************************************************************************/
+inline void fft(std::complex<double>* data, std::size_t n, std::size_t stride,
+                bool inverse = false)
+{
+        if(!is_power_of_two(n)){
+                throw std::invalid_argument("fft: size must be a power of two");
+        }
+        const auto at = [data, stride](std::size_t i) -> std::complex<double>&
+                        {
+                                return data[i*stride];
+                        };
+        // Bit reversal permutation
+        for(std::size_t i = 1, j = 0; i < n; i++){
+                std::size_t bit = n >> 1;
+                for(; j & bit; bit >>= 1){
+                        j ^= bit;
+                }
+                j ^= bit;
+                if(i < j){
+                        std::swap(at(i), at(j));
+                }
+        }
+        const double pi = std::acos(-1.);
+        for(std::size_t length = 2; length <= n; length <<= 1){
+                const double angle = (inverse ? 2 : -2)*pi/length;
+                const std::complex<double> step(std::cos(angle),
+                                                std::sin(angle));
+                for(std::size_t start = 0; start < n; start += length){
+                        std::complex<double> w(1);
+                        for(std::size_t k = 0; k < length/2; k++){
+                                const std::complex<double> u = at(start + k);
+                                const std::complex<double> v =
+                                        at(start + k + length/2)*w;
+                                at(start + k) = u + v;
+                                at(start + k + length/2) = u - v;
+                                w *= step;
+                        }
+                }
+        }
+        if(inverse){
+                for(std::size_t i = 0; i < n; i++){
+                        at(i) /= static_cast<double>(n);
+                }
+        }
+}
+
+inline void fft(std::vector<std::complex<double>>& data, bool inverse = false)
+{
+        fft(data.data(), data.size(), 1, inverse);
+}
+
+/*!*****************************************************************************
+ * In place Fourier transform of a field over a periodic parallelogram of
+ * hexagons. In the skewed (a, b) basis of Hexagon, the hexagonal lattice
+ * wrapped on a width x height parallelogram is the group
+ * \f$ \mathbb{Z}_{width} \times \mathbb{Z}_{height} \f$, so the transform
+ * is a 2D FFT over a and b. Value (k, l) of the result (stored at
+ * origin + (k, l)) is the coefficient of
+ * \f$ e^{2\pi i (ka/width + lb/height)} \f$. As for any Fourier transform
+ * on a group, a convolution over the periodic hexagonal lattice becomes a
+ * pointwise product of the transforms.
+ * width and height must be non-zero powers of two, otherwise
+ * std::invalid_argument is thrown. Rows, then columns, are transformed in
+ * parallel on num_threads threads.
+ ******************************************************************************/
+inline void hex_fft(HexField<std::complex<double>>& field, bool inverse = false,
+                    unsigned num_threads = 0)
+{
+        const std::size_t width = field.width(), height = field.height();
+        // Checked here, fft() throwing on a worker thread would terminate.
+        if(!is_power_of_two(width) || !is_power_of_two(height)){
+                throw std::invalid_argument(
+                        "hex_fft: width and height must be powers of two");
+        }
+        std::complex<double>* data = field.values().data();
+        parallel_for(height, num_threads,
+                     [=](std::size_t row)
+                     {
+                             fft(data + row*width, width, 1, inverse);
+                     });
+        parallel_blocks(width, num_threads,
+                        [=](std::size_t begin, std::size_t end, unsigned)
+                        {
+                                // Transform contiguous copies of the columns,
+                                // strided access is much slower.
+                                std::vector<std::complex<double>> column(height);
+                                for(std::size_t c = begin; c < end; c++){
+                                        for(std::size_t r = 0; r < height; r++){
+                                                column[r] = data[c + r*width];
+                                        }
+                                        fft(column, inverse);
+                                        for(std::size_t r = 0; r < height; r++){
+                                                data[c + r*width] = column[r];
+                                        }
+                                }
+                        });
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_FFT_H
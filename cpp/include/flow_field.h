@@ -0,0 +1,255 @@
+#ifndef HEXAGON_FLOW_FIELD_H
+#define HEXAGON_FLOW_FIELD_H
+
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <queue>
+
+#include <hexagon.h>
+#include <hex_field.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup FlowField FlowField
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Shortest path directions from every cell of a cost grid to the nearest of
+ * a set of goals, for steering any number of agents towards the same goals.
+ * As in find_path(), cost(hex) is paid when entering hex and an infinite cost
+ * makes the cell impassable. The field is built with one Dijkstra pass
+ * started from all goals at once.
+ * For every cell the best step is stored as a 3 bit code (21 cells per 64
+ * bit word): an index into neighbor_directions, goal, or none for cells
+ * that are impassable or can not reach any goal.
+ ******************************************************************************/
+class FlowField{
+public:
+        enum : int{
+                goal = 6,
+                none = 7
+        };
+
+        /*!*********************************************************************
+         * Build the flow field over costs towards goals. Goals outside the
+         * field are ignored.
+         **********************************************************************/
+        FlowField(HexField<double> costs, const std::vector<Hexagon>& goals)
+         : costs_(std::move(costs)),
+           distances_(costs_.origin(), costs_.width(), costs_.height(),
+                      std::numeric_limits<double>::infinity()),
+           // Every 3 bit code set to none
+           codes_((costs_.size() + cells_per_word - 1)/cells_per_word,
+                  0x7fffffffffffffffull)
+        {
+                Queue queue;
+                for(const auto& hex : goals){
+                        if(!costs_.contains(hex)){
+                                continue;
+                        }
+                        const std::size_t i = costs_.index(hex);
+                        distances_.values()[i] = 0;
+                        set_code(i, goal);
+                        queue.push({0., i});
+                }
+                propagate(queue);
+        }
+
+        /*!*********************************************************************
+         * Return the code of the best step from hex, none for cells outside
+         * the field.
+         **********************************************************************/
+        int direction(Hexagon hex) const
+        {
+                return costs_.contains(hex) ? code(costs_.index(hex)) : none;
+        }
+
+        /*!*********************************************************************
+         * Return the cell an agent at hex should move to, or hex itself at a
+         * goal or if no goal can be reached.
+         **********************************************************************/
+        Hexagon next(Hexagon hex) const
+        {
+                const int dir = direction(hex);
+                return dir < 6 ? hex + neighbor_directions[dir] : hex;
+        }
+
+        /*!*********************************************************************
+         * Return the total cost from hex to the nearest goal, infinity if no
+         * goal can be reached.
+         **********************************************************************/
+        double distance(Hexagon hex) const
+        {
+                return distances_.get(hex,
+                                      std::numeric_limits<double>::infinity());
+        }
+
+        const HexField<double>& costs() const
+        {
+                return costs_;
+        }
+
+        const HexField<double>& distances() const
+        {
+                return distances_;
+        }
+
+        /*!*********************************************************************
+         * Change the cost of hex (which must lie inside the field). The
+         * directions are not updated until repair() is called, so several
+         * changes can be repaired together.
+         **********************************************************************/
+        void set_cost(Hexagon hex, double cost)
+        {
+                costs_[hex] = cost;
+                changed_.push_back(costs_.index(hex));
+        }
+
+        /*!*********************************************************************
+         * Update the field after calls to set_cost(). Every cell whose path
+         * ran through a changed cell is invalidated, then Dijkstra is run
+         * again from the valid cells around the invalidated ones and from the
+         * changed cells. Only the affected part of the field is touched.
+         * Returns the number of invalidated cells.
+         **********************************************************************/
+        std::size_t repair()
+        {
+                constexpr double inf = std::numeric_limits<double>::infinity();
+                std::vector<std::size_t> invalid;
+                for(std::size_t x : changed_){
+                        if(costs_.values()[x] == inf && code(x) != goal){
+                                invalidate(x, invalid);
+                        }
+                        // Cells stepping onto x pay its cost.
+                        for_each_neighbor(x, [&](std::size_t c, int dir)
+                        {
+                                if(code(c) == (dir + 3) % 6){
+                                        invalidate(c, invalid);
+                                }
+                        });
+                }
+                // Subtrees of the invalidated cells (breadth first, invalid
+                // grows while it is walked).
+                for(std::size_t k = 0; k < invalid.size(); k++){
+                        for_each_neighbor(invalid[k], [&](std::size_t c, int dir)
+                        {
+                                if(code(c) == (dir + 3) % 6){
+                                        invalidate(c, invalid);
+                                }
+                        });
+                }
+
+                Queue queue;
+                const auto& distances = distances_.values();
+                const auto seed = [&](std::size_t c, int)
+                                  {
+                                          if(distances[c] < inf){
+                                                  queue.push({distances[c], c});
+                                          }
+                                  };
+                for(std::size_t c : invalid){
+                        for_each_neighbor(c, seed);
+                }
+                for(std::size_t x : changed_){
+                        seed(x, 0);
+                        for_each_neighbor(x, seed);
+                }
+                changed_.clear();
+                propagate(queue);
+                return invalid.size();
+        }
+
+private:
+        static constexpr int cells_per_word = 21;
+
+        using Entry = std::pair<double, std::size_t>;
+        using Queue = std::priority_queue<Entry, std::vector<Entry>,
+                                          std::greater<Entry>>;
+
+        HexField<double> costs_;
+        HexField<double> distances_;
+        std::vector<std::uint64_t> codes_;
+        std::vector<std::size_t> changed_;
+
+        int code(std::size_t i) const
+        {
+                return static_cast<int>(codes_[i/cells_per_word] >>
+                                        3*(i % cells_per_word) & 7);
+        }
+
+        void set_code(std::size_t i, int code)
+        {
+                const int shift = 3*(i % cells_per_word);
+                std::uint64_t& word = codes_[i/cells_per_word];
+                word = (word & ~(std::uint64_t{7} << shift)) |
+                       static_cast<std::uint64_t>(code) << shift;
+        }
+
+        void invalidate(std::size_t i, std::vector<std::size_t>& invalid)
+        {
+                if(code(i) == none){
+                        return;
+                }
+                set_code(i, none);
+                distances_.values()[i] = std::numeric_limits<double>::infinity();
+                invalid.push_back(i);
+        }
+
+        /*!*********************************************************************
+         * Call f(index, direction) for the neighbours of cell i inside the
+         * field, direction being the index into neighbor_directions of the
+         * step from i to the neighbour.
+         **********************************************************************/
+        template<class F>
+        void for_each_neighbor(std::size_t i, F f) const
+        {
+                const Hexagon hex = costs_.hex(i);
+                for(int dir = 0; dir < 6; dir++){
+                        const Hexagon neighbor = hex + neighbor_directions[dir];
+                        if(costs_.contains(neighbor)){
+                                f(costs_.index(neighbor), dir);
+                        }
+                }
+        }
+
+        /*!*********************************************************************
+         * Dijkstra: relax the neighbours of queued cells until the queue is
+         * empty. A cell c next to n gets distance(n) + cost(n) and points
+         * at n if that is an improvement.
+         **********************************************************************/
+        void propagate(Queue& queue)
+        {
+                constexpr double inf = std::numeric_limits<double>::infinity();
+                auto& distances = distances_.values();
+                const auto& costs = costs_.values();
+                while(!queue.empty()){
+                        const Entry top = queue.top();
+                        queue.pop();
+                        const std::size_t n = top.second;
+                        if(top.first > distances[n]){
+                                continue; // Stale queue entry
+                        }
+                        const double candidate = distances[n] + costs[n];
+                        if(candidate == inf){
+                                continue;
+                        }
+                        for_each_neighbor(n, [&](std::size_t c, int dir)
+                        {
+                                if(costs[c] == inf || candidate >= distances[c]){
+                                        return;
+                                }
+                                distances[c] = candidate;
+                                set_code(c, (dir + 3) % 6);
+                                queue.push({candidate, c});
+                        });
+                }
+        }
+};
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_FLOW_FIELD_H
@@ -0,0 +1,362 @@
+#ifndef HEXAGON_GRID_H
+#define HEXAGON_GRID_H
+
+#include <array>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <point.h>
+#include <hexagon.h>
+#include <square.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Grid Grid
+ * Grid independent algorithms. A grid is described by a tag type (HexGrid,
+ * SquareGrid4, SquareGrid8) and a matching specialization of grid_traits.
+ * All algorithms are templates on the grid tag, so they are specialized at
+ * compile time for each grid (no virtual dispatch).
+ * @{
+ ******************************************************************************/
+
+/*!*****************************************************************************
+ * Tag for the hexagonal grid, using Hexagon cells.
+ ******************************************************************************/
+struct HexGrid{};
+
+/*!*****************************************************************************
+ * Tag for the 4-connected square grid (edge-sharing neighbours only), using
+ * Square cells.
+ ******************************************************************************/
+struct SquareGrid4{};
+
+/*!*****************************************************************************
+ * Tag for the 8-connected square grid (edge- and corner-sharing neighbours),
+ * using Square cells.
+ ******************************************************************************/
+struct SquareGrid8{};
+
+/*!*****************************************************************************
+ * Description of a grid. Every specialization provides
+ *  - cell_type, the integer cell coordinate type,
+ *  - num_directions and directions(), the steps to all neighbouring cells,
+ *  - distance(a, b), the number of steps needed to move from a to b,
+ *  - to_point(cell) and nearest_cell(point), conversions to and from
+ *    cartesian coordinates,
+ *  - ring_start() and ring_sides(), used for walking rings. A ring of radius
+ *    r starts at center + r*ring_start() and walks
+ *    ring_side_length(r) steps along each of the ring_sides() in turn.
+ ******************************************************************************/
+template<class Grid>
+struct grid_traits;
+
+template<>
+struct grid_traits<HexGrid>{
+        using cell_type = Hexagon;
+        static constexpr std::size_t num_directions = 6;
+
+        static const std::array<Hexagon, 6>& directions()
+        {
+                return neighbor_directions;
+        }
+
+        static int distance(Hexagon a, Hexagon b)
+        {
+                return manhattan_distance(a - b);
+        }
+
+        static Point to_point(Hexagon hex)
+        {
+                return hex.to_point();
+        }
+
+        static Hexagon nearest_cell(Point p)
+        {
+                return nearest_hex(p);
+        }
+
+        static Hexagon ring_start()
+        {
+                return neighbor_directions[4];
+        }
+
+        static const std::array<Hexagon, 6>& ring_sides()
+        {
+                return neighbor_directions;
+        }
+
+        static int ring_side_length(int radius)
+        {
+                return radius;
+        }
+};
+
+template<>
+struct grid_traits<SquareGrid4>{
+        using cell_type = Square;
+        static constexpr std::size_t num_directions = 4;
+
+        static const std::array<Square, 4>& directions()
+        {
+                return square_neighbor_directions_4;
+        }
+
+        static int distance(Square a, Square b)
+        {
+                return manhattan_distance(a - b);
+        }
+
+        static Point to_point(Square sq)
+        {
+                return sq.to_point();
+        }
+
+        static Square nearest_cell(Point p)
+        {
+                return nearest_square(p);
+        }
+
+        /*!*********************************************************************
+         * Rings on the 4-connected grid are diamonds, walked along the
+         * diagonals.
+         **********************************************************************/
+        static Square ring_start()
+        {
+                return Square{0, -1};
+        }
+
+        static const std::array<Square, 4>& ring_sides()
+        {
+                static const std::array<Square, 4> sides{
+                        Square{1, 1}, Square{-1, 1},
+                        Square{-1, -1}, Square{1, -1}
+                };
+                return sides;
+        }
+
+        static int ring_side_length(int radius)
+        {
+                return radius;
+        }
+};
+
+template<>
+struct grid_traits<SquareGrid8>{
+        using cell_type = Square;
+        static constexpr std::size_t num_directions = 8;
+
+        static const std::array<Square, 8>& directions()
+        {
+                return square_neighbor_directions_8;
+        }
+
+        static int distance(Square a, Square b)
+        {
+                return chebyshev_distance(a - b);
+        }
+
+        static Point to_point(Square sq)
+        {
+                return sq.to_point();
+        }
+
+        static Square nearest_cell(Point p)
+        {
+                return nearest_square(p);
+        }
+
+        /*!*********************************************************************
+         * Rings on the 8-connected grid are squares, walked along the axes.
+         **********************************************************************/
+        static Square ring_start()
+        {
+                return Square{-1, -1};
+        }
+
+        static const std::array<Square, 4>& ring_sides()
+        {
+                return square_neighbor_directions_4;
+        }
+
+        static int ring_side_length(int radius)
+        {
+                return 2*radius;
+        }
+};
+
+/*!*****************************************************************************
+ * Return all neighbours of cell, in the order given by
+ * grid_traits<Grid>::directions().
+ ******************************************************************************/
+template<class Grid>
+std::array<typename grid_traits<Grid>::cell_type,
+           grid_traits<Grid>::num_directions>
+neighbors(typename grid_traits<Grid>::cell_type cell)
+{
+        using traits = grid_traits<Grid>;
+        std::array<typename traits::cell_type, traits::num_directions> res;
+        std::transform(std::begin(traits::directions()),
+                       std::end(traits::directions()),
+                       std::begin(res),
+                       [cell](typename traits::cell_type dir)
+                       {
+                                return cell + dir;
+                       });
+        return res;
+}
+
+/*!*****************************************************************************
+ * Return a std::vector containing all cells at radius steps away from center.
+ * For HexGrid the result is identical to Hex::ring.
+ ******************************************************************************/
+template<class Grid>
+std::vector<typename grid_traits<Grid>::cell_type>
+ring(typename grid_traits<Grid>::cell_type center, int radius)
+{
+        using traits = grid_traits<Grid>;
+        if(radius == 0){
+                return {center};
+        }
+        const int side_length = traits::ring_side_length(radius);
+        std::vector<typename traits::cell_type> res;
+        res.reserve(traits::ring_sides().size()*side_length);
+        auto current = center + radius*traits::ring_start();
+        for(const auto& side : traits::ring_sides()){
+                for(int step = 0; step < side_length; step++){
+                        res.push_back(current);
+                        current += side;
+                }
+        }
+        return res;
+}
+
+/*!*****************************************************************************
+ * Return a std::vector containing all cells inside radius steps away from
+ * center, ring by ring, starting with center itself.
+ * For HexGrid the result is identical to Hex::spiral.
+ ******************************************************************************/
+template<class Grid>
+std::vector<typename grid_traits<Grid>::cell_type>
+spiral(typename grid_traits<Grid>::cell_type center, int radius)
+{
+        std::vector<typename grid_traits<Grid>::cell_type> res;
+        for(int r = 0; r <= radius; r++){
+                const auto current_ring = ring<Grid>(center, r);
+                res.insert(res.end(), current_ring.begin(), current_ring.end());
+        }
+        return res;
+}
+
+/*!*****************************************************************************
+ * Return all cells connected to start through cells for which
+ * passable(cell) is true, in breadth first order. If max_radius is
+ * non-negative, cells further than max_radius steps from start are never
+ * visited (needed if the passable region is unbounded).
+ * If start itself is not passable the result is empty.
+ ******************************************************************************/
+template<class Grid, class Passable>
+std::vector<typename grid_traits<Grid>::cell_type>
+flood_fill(typename grid_traits<Grid>::cell_type start, Passable passable,
+           int max_radius = -1)
+{
+        using traits = grid_traits<Grid>;
+        using cell_type = typename traits::cell_type;
+        std::vector<cell_type> res;
+        if(!passable(start)){
+                return res;
+        }
+        std::unordered_set<cell_type> visited{start};
+        res.push_back(start);
+        for(std::size_t i = 0; i < res.size(); i++){
+                for(const auto& dir : traits::directions()){
+                        const cell_type next = res[i] + dir;
+                        if(max_radius >= 0 &&
+                           traits::distance(start, next) > max_radius){
+                                continue;
+                        }
+                        if(visited.count(next) || !passable(next)){
+                                continue;
+                        }
+                        visited.insert(next);
+                        res.push_back(next);
+                }
+        }
+        return res;
+}
+
+/*!*****************************************************************************
+ * Find the cheapest path from start to goal using A*. cost(cell) returns the
+ * cost of entering cell, it should be at least 1 for the step distance to be
+ * an admissible heuristic. A cost of infinity marks the cell as impassable.
+ * If max_radius is non-negative, cells further than max_radius steps from
+ * start are never visited.
+ * The returned path includes both start and goal, and is empty if no path
+ * could be found.
+ ******************************************************************************/
+template<class Grid, class Cost>
+std::vector<typename grid_traits<Grid>::cell_type>
+find_path(typename grid_traits<Grid>::cell_type start,
+          typename grid_traits<Grid>::cell_type goal, Cost cost,
+          int max_radius = -1)
+{
+        using traits = grid_traits<Grid>;
+        using cell_type = typename traits::cell_type;
+        using entry = std::pair<double, cell_type>;
+        const auto greater = [](const entry& a, const entry& b)
+                             {
+                                     return a.first > b.first;
+                             };
+        std::priority_queue<entry, std::vector<entry>, decltype(greater)>
+                open(greater);
+        std::unordered_map<cell_type, double> g_score{{start, 0.}};
+        std::unordered_map<cell_type, cell_type> came_from;
+
+        open.push({static_cast<double>(traits::distance(start, goal)), start});
+        while(!open.empty()){
+                const cell_type current = open.top().second;
+                const double f = open.top().first;
+                open.pop();
+                const double g = g_score[current];
+                if(f > g + traits::distance(current, goal)){
+                        continue; // Stale queue entry
+                }
+                if(current == goal){
+                        std::vector<cell_type> path{goal};
+                        while(path.back() != start){
+                                path.push_back(came_from[path.back()]);
+                        }
+                        std::reverse(path.begin(), path.end());
+                        return path;
+                }
+                for(const auto& dir : traits::directions()){
+                        const cell_type next = current + dir;
+                        if(max_radius >= 0 &&
+                           traits::distance(start, next) > max_radius){
+                                continue;
+                        }
+                        const double step = cost(next);
+                        if(step == std::numeric_limits<double>::infinity()){
+                                continue;
+                        }
+                        const auto it = g_score.find(next);
+                        if(it != g_score.end() && it->second <= g + step){
+                                continue;
+                        }
+                        g_score[next] = g + step;
+                        came_from[next] = current;
+                        open.push({g + step + traits::distance(next, goal),
+                                   next});
+                }
+        }
+        return {};
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_GRID_H
@@ -0,0 +1,119 @@
+#ifndef HEXAGON_HEX_FIELD_H
+#define HEXAGON_HEX_FIELD_H
+
+#include <vector>
+
+#include <hexagon.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup HexField HexField
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Dense field of T over a parallelogram of hexagons,
+ * \f$ a \in [a_0, a_0 + width)\f$, \f$ b \in [b_0, b_0 + height)\f$, where
+ * \f$(a_0, b_0)\f$ is the origin. Values are stored row by row, with a
+ * running fastest, i.e. the hexagon (a, b) is stored at index
+ * \f$ (a - a_0) + width (b - b_0)\f$.
+ * Use unsigned char rather than bool for masks (std::vector<bool> does not
+ * store addressable values).
+ ******************************************************************************/
+template<class T>
+class HexField{
+public:
+        using value_type = T;
+
+        HexField() = default;
+
+        HexField(Hexagon origin, int width, int height, T value = T{})
+         : origin_(origin), width_(width), height_(height),
+           values_(static_cast<std::size_t>(width)*height, value)
+        {}
+
+        Hexagon origin() const
+        {
+                return origin_;
+        }
+
+        int width() const
+        {
+                return width_;
+        }
+
+        int height() const
+        {
+                return height_;
+        }
+
+        std::size_t size() const
+        {
+                return values_.size();
+        }
+
+        /*!*********************************************************************
+         * Return true if hex lies inside the field.
+         **********************************************************************/
+        bool contains(Hexagon hex) const
+        {
+                return hex.a >= origin_.a && hex.a < origin_.a + width_ &&
+                       hex.b >= origin_.b && hex.b < origin_.b + height_;
+        }
+
+        /*!*********************************************************************
+         * Return the storage index of hex, which must lie inside the field.
+         **********************************************************************/
+        std::size_t index(Hexagon hex) const
+        {
+                return static_cast<std::size_t>(hex.a - origin_.a) +
+                       static_cast<std::size_t>(width_)*(hex.b - origin_.b);
+        }
+
+        /*!*********************************************************************
+         * Return the hexagon stored at index i.
+         **********************************************************************/
+        Hexagon hex(std::size_t i) const
+        {
+                return origin_ + Hexagon{static_cast<int>(i % width_),
+                                         static_cast<int>(i / width_)};
+        }
+
+        T& operator[](Hexagon hex)
+        {
+                return values_[this->index(hex)];
+        }
+
+        const T& operator[](Hexagon hex) const
+        {
+                return values_[this->index(hex)];
+        }
+
+        /*!*********************************************************************
+         * Return the value at hex, or fallback if hex lies outside the field.
+         **********************************************************************/
+        T get(Hexagon hex, T fallback = T{}) const
+        {
+                return this->contains(hex) ? values_[this->index(hex)] :
+                                             fallback;
+        }
+
+        std::vector<T>& values()
+        {
+                return values_;
+        }
+
+        const std::vector<T>& values() const
+        {
+                return values_;
+        }
+
+private:
+        Hexagon origin_;
+        int width_ = 0, height_ = 0;
+        std::vector<T> values_;
+};
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_HEX_FIELD_H
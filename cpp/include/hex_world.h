@@ -0,0 +1,409 @@
+#ifndef HEXAGON_HEX_WORLD_H
+#define HEXAGON_HEX_WORLD_H
+
+#include <array>
+#include <bitset>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include <hexagon.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup HexWorld HexWorld
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Pool of objects of type T, handing out pointers to objects. Objects are
+ * allocated in blocks of BlockSize and are never moved, released objects are
+ * put on a free list and reused before a new block is allocated. All memory is
+ * freed when the pool is destroyed.
+ ******************************************************************************/
+template<class T, std::size_t BlockSize = 8>
+class Pool{
+public:
+        /*!*********************************************************************
+         * Return a pointer to a T owned by the pool. Newly allocated objects
+         * are default constructed, released objects are reused as they are.
+         **********************************************************************/
+        T* acquire()
+        {
+                if(free_.empty()){
+                        blocks_.emplace_back(new T[BlockSize]);
+                        for(std::size_t i = BlockSize; i > 0; i--){
+                                free_.push_back(&blocks_.back()[i - 1]);
+                        }
+                        return acquire();
+                }
+                T* res = free_.back();
+                free_.pop_back();
+                return res;
+        }
+
+        /*!*********************************************************************
+         * Give obj back to the pool. It is handed out again as is, it is up
+         * to the user to reset it.
+         **********************************************************************/
+        void release(T* obj)
+        {
+                free_.push_back(obj);
+        }
+
+        /*!*********************************************************************
+         * Return the number of objects allocated by the pool, in use or not.
+         **********************************************************************/
+        std::size_t capacity() const
+        {
+                return blocks_.size()*BlockSize;
+        }
+
+private:
+        std::vector<std::unique_ptr<T[]>> blocks_;
+        std::vector<T*> free_;
+};
+
+/*!*****************************************************************************
+ * Sparse, unbounded container of T keyed by Hexagon. The plane is split into
+ * parallelogram chunks of \f$2^{ChunkBits} \times 2^{ChunkBits}\f$ hexagons
+ * in (a, b) space. Chunks are dense arrays allocated from a Pool the first
+ * time a cell inside them is written, and are found through a hash table
+ * keyed by the chunk coordinates.
+ * Cells that have never been written read as T{} and are skipped when
+ * iterating.
+ * Writes are tracked: every cell handed out for writing is marked dirty in a
+ * per-chunk bitmap, and chunks with dirty cells are kept in a list, so the
+ * changes since the last snapshot() are found in time proportional to the
+ * number of dirty chunks rather than the size of the world.
+ ******************************************************************************/
+template<class T, int ChunkBits = 6>
+class HexWorld{
+public:
+        static constexpr int chunk_size = 1 << ChunkBits;
+        static constexpr int cells_per_chunk = chunk_size*chunk_size;
+        static constexpr int dirty_words = (cells_per_chunk + 63)/64;
+
+        /*!*********************************************************************
+         * A dense chunk of cells. The cell with local coordinates (a, b) is
+         * stored at index a + chunk_size*b. Bit i % 64 of dirty[i / 64] is
+         * set if cell i has been written since the last snapshot().
+         **********************************************************************/
+        struct Chunk{
+                Hexagon origin;
+                std::array<T, cells_per_chunk> cells{};
+                std::bitset<cells_per_chunk> occupied;
+                std::array<std::uint64_t, dirty_words> dirty{};
+                bool dirty_listed = false;
+        };
+
+        /*!*********************************************************************
+         * Return the coordinates of the chunk containing hex. Note that the
+         * shift rounds towards negative infinity for negative coordinates.
+         **********************************************************************/
+        static Hexagon chunk_of(Hexagon hex)
+        {
+                return {hex.a >> ChunkBits, hex.b >> ChunkBits};
+        }
+
+        /*!*********************************************************************
+         * Return the index of hex inside its chunk.
+         **********************************************************************/
+        static int local_index(Hexagon hex)
+        {
+                return (hex.a & (chunk_size - 1)) +
+                       chunk_size*(hex.b & (chunk_size - 1));
+        }
+
+        HexWorld() = default;
+        HexWorld(const HexWorld&) = delete;
+        HexWorld& operator=(const HexWorld&) = delete;
+        HexWorld(HexWorld&&) = default;
+        HexWorld& operator=(HexWorld&&) = default;
+
+        /*!*********************************************************************
+         * Return a reference to the value stored at hex, allocating the
+         * containing chunk if needed. The cell is marked as occupied and
+         * dirty.
+         **********************************************************************/
+        T& operator[](Hexagon hex)
+        {
+                Chunk* chunk = this->chunk(chunk_of(hex), true);
+                const int i = local_index(hex);
+                if(!chunk->occupied[i]){
+                        chunk->occupied[i] = true;
+                        size_++;
+                }
+                mark_dirty(*chunk, i);
+                return chunk->cells[i];
+        }
+
+        void set(Hexagon hex, const T& value)
+        {
+                (*this)[hex] = value;
+        }
+
+        /*!*********************************************************************
+         * Return a pointer to the value stored at hex, or nullptr if the cell
+         * has never been written. Never allocates.
+         **********************************************************************/
+        const T* find(Hexagon hex) const
+        {
+                const Chunk* chunk = this->chunk(chunk_of(hex));
+                const int i = local_index(hex);
+                if(!chunk || !chunk->occupied[i]){
+                        return nullptr;
+                }
+                return &chunk->cells[i];
+        }
+
+        /*!*********************************************************************
+         * As above, but the returned cell may be written and is marked dirty.
+         **********************************************************************/
+        T* find(Hexagon hex)
+        {
+                Chunk* chunk = this->chunk(chunk_of(hex), false);
+                const int i = local_index(hex);
+                if(!chunk || !chunk->occupied[i]){
+                        return nullptr;
+                }
+                mark_dirty(*chunk, i);
+                return &chunk->cells[i];
+        }
+
+        /*!*********************************************************************
+         * Return the value stored at hex, or T{} if the cell has never been
+         * written. Never allocates.
+         **********************************************************************/
+        T get(Hexagon hex) const
+        {
+                const T* res = this->find(hex);
+                return res ? *res : T{};
+        }
+
+        bool contains(Hexagon hex) const
+        {
+                return this->find(hex) != nullptr;
+        }
+
+        /*!*********************************************************************
+         * Call f(neighbor, value) for each of the 6 neighbours of hex, in the
+         * order of neighbor_directions. value is a pointer to the stored
+         * value, or nullptr if the neighbour has never been written.
+         * Neighbours inside the chunk of hex are found without any chunk
+         * lookup, only cells on the chunk border look up neighbouring
+         * chunks.
+         **********************************************************************/
+        template<class F>
+        void for_each_neighbor(Hexagon hex, F f) const
+        {
+                const Hexagon chunk_coord = chunk_of(hex);
+                const Chunk* chunk = this->chunk(chunk_coord);
+                const int la = hex.a & (chunk_size - 1);
+                const int lb = hex.b & (chunk_size - 1);
+                const bool interior = la > 0 && la < chunk_size - 1 &&
+                                      lb > 0 && lb < chunk_size - 1;
+                for(const auto& dir : neighbor_directions){
+                        const Hexagon neighbor = hex + dir;
+                        const Chunk* c = chunk;
+                        if(!interior && chunk_of(neighbor) != chunk_coord){
+                                c = this->chunk(chunk_of(neighbor));
+                        }
+                        const int i = local_index(neighbor);
+                        f(neighbor, c && c->occupied[i] ? &c->cells[i] :
+                                                          nullptr);
+                }
+        }
+
+        /*!*********************************************************************
+         * Call f(hex, value) for every occupied cell. Only allocated chunks
+         * are visited, in no particular order. The non-const version marks
+         * every cell it visits as dirty, use the const one to only read.
+         **********************************************************************/
+        template<class F>
+        void for_each(F f)
+        {
+                for(auto& entry : chunks_){
+                        Chunk& chunk = *entry.second;
+                        auto write = [this, &chunk, &f](Hexagon hex, T& value)
+                                     {
+                                             mark_dirty(chunk, local_index(hex));
+                                             f(hex, value);
+                                     };
+                        visit_chunk(chunk, write);
+                }
+        }
+
+        template<class F>
+        void for_each(F f) const
+        {
+                for(const auto& entry : chunks_){
+                        visit_chunk(
+                                static_cast<const Chunk&>(*entry.second), f);
+                }
+        }
+
+        /*!*********************************************************************
+         * Call f(hex, value) for every occupied cell written since the last
+         * snapshot(). Chunks are visited in the order they were first
+         * written to, cells within a chunk in storage order (a fastest).
+         * Runs in time proportional to the number of dirty chunks.
+         **********************************************************************/
+        template<class F>
+        void for_each_dirty(F f) const
+        {
+                for(const Chunk* chunk : dirty_chunks_){
+                        for(int w = 0; w < dirty_words; w++){
+                                const std::uint64_t word = chunk->dirty[w];
+                                if(word == 0){
+                                        continue;
+                                }
+                                for(int bit = 0; bit < 64; bit++){
+                                        if(!(word >> bit & 1)){
+                                                continue;
+                                        }
+                                        const int i = 64*w + bit;
+                                        if(chunk->occupied[i]){
+                                                f(chunk->origin +
+                                                  Hexagon{i % chunk_size,
+                                                          i / chunk_size},
+                                                  static_cast<const T&>(
+                                                          chunk->cells[i]));
+                                        }
+                                }
+                        }
+                }
+        }
+
+        /*!*********************************************************************
+         * Return true if clear() has been called since the last snapshot(),
+         * i.e. cells may have been removed, not just written.
+         **********************************************************************/
+        bool cleared() const
+        {
+                return cleared_;
+        }
+
+        /*!*********************************************************************
+         * Return the number of snapshot() calls so far. A replica that has
+         * applied all changes up to snapshot e is in sync with epoch() == e.
+         **********************************************************************/
+        std::uint64_t epoch() const
+        {
+                return epoch_;
+        }
+
+        /*!*********************************************************************
+         * Mark all cells as clean and start a new epoch. Returns the new
+         * epoch. Only the dirty chunks are touched.
+         **********************************************************************/
+        std::uint64_t snapshot()
+        {
+                for(Chunk* chunk : dirty_chunks_){
+                        chunk->dirty.fill(0);
+                        chunk->dirty_listed = false;
+                }
+                dirty_chunks_.clear();
+                cleared_ = false;
+                return ++epoch_;
+        }
+
+        /*!*********************************************************************
+         * Return the number of occupied cells.
+         **********************************************************************/
+        std::size_t size() const
+        {
+                return size_;
+        }
+
+        bool empty() const
+        {
+                return size_ == 0;
+        }
+
+        /*!*********************************************************************
+         * Return the number of allocated chunks.
+         **********************************************************************/
+        std::size_t chunk_count() const
+        {
+                return chunks_.size();
+        }
+
+        /*!*********************************************************************
+         * Remove all cells, handing all chunks back to the pool (the memory is
+         * kept for reuse). All dirty state is dropped and cleared() returns
+         * true until the next snapshot().
+         **********************************************************************/
+        void clear()
+        {
+                for(auto& entry : chunks_){
+                        pool_.release(entry.second);
+                }
+                chunks_.clear();
+                dirty_chunks_.clear();
+                size_ = 0;
+                cleared_ = true;
+        }
+
+private:
+        Pool<Chunk> pool_;
+        std::unordered_map<Hexagon, Chunk*> chunks_;
+        std::vector<Chunk*> dirty_chunks_;
+        std::size_t size_ = 0;
+        std::uint64_t epoch_ = 0;
+        bool cleared_ = false;
+
+        void mark_dirty(Chunk& chunk, int i)
+        {
+                if(!chunk.dirty_listed){
+                        chunk.dirty_listed = true;
+                        dirty_chunks_.push_back(&chunk);
+                }
+                chunk.dirty[i / 64] |= std::uint64_t{1} << (i % 64);
+        }
+
+        const Chunk* chunk(Hexagon chunk_coord) const
+        {
+                const auto it = chunks_.find(chunk_coord);
+                return it == chunks_.end() ? nullptr : it->second;
+        }
+
+        Chunk* chunk(Hexagon chunk_coord, bool allocate)
+        {
+                auto it = chunks_.find(chunk_coord);
+                if(it != chunks_.end()){
+                        return it->second;
+                }
+                if(!allocate){
+                        return nullptr;
+                }
+                Chunk* res = pool_.acquire();
+                res->cells.fill(T{});
+                res->occupied.reset();
+                res->dirty.fill(0);
+                res->dirty_listed = false;
+                res->origin = chunk_coord*chunk_size;
+                chunks_.emplace(chunk_coord, res);
+                return res;
+        }
+
+        template<class C, class F>
+        static void visit_chunk(C& chunk, F& f)
+        {
+                if(chunk.occupied.none()){
+                        return;
+                }
+                for(int i = 0; i < cells_per_chunk; i++){
+                        if(chunk.occupied[i]){
+                                f(chunk.origin + Hexagon{i % chunk_size,
+                                                         i / chunk_size},
+                                  chunk.cells[i]);
+                        }
+                }
+        }
+};
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_HEX_WORLD_H
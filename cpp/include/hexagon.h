@@ -6,9 +6,11 @@
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <functional>
 
 #include <point.h>
 #include <edge.h>
+#include <instrumentation.h>
 
 namespace Hex{
 struct Hexagon;
@@ -68,7 +70,7 @@ Point point_from_hex(Hexagon hex);
  * only for integer coordinates (a, b).
 *******************************************************************************/
 struct Hexagon{
-        int a, b;
+        int a = 0, b = 0;
 
         /*!*********************************************************************
          * A Hexagon Wedge is formed by three points; the center and two 
@@ -332,11 +334,13 @@ static const std::array<Hexagon, 6> neighbor_directions {
  ******************************************************************************/
 inline std::vector<Hexagon> ring(Hexagon center, int radius)
 {
+        HEX_COUNT("ring");
         if(radius == 0){
                 return {center};
         }
         std::vector<Hexagon> res;
         res.reserve(6*radius);
+        HEX_COUNT_BYTES("ring", 6*radius*sizeof(Hexagon));
         Hexagon current = center + radius*neighbor_directions[4];
         for(const auto& direction : neighbor_directions){
                 for(int step = 0; step < radius; step++){
@@ -354,9 +358,12 @@ inline std::vector<Hexagon> ring(Hexagon center, int radius)
  ******************************************************************************/
 inline std::vector<Hexagon> spiral(Hexagon center, int radius)
 {
+        HEX_TRACE_SCOPE("spiral");
+        HEX_COUNT("spiral");
         using std::make_move_iterator;
         std::vector<Hexagon> res;
         res.reserve(1 + 3*radius*(radius + 1));
+        HEX_COUNT_BYTES("spiral", (1 + 3*radius*(radius + 1))*sizeof(Hexagon));
 
        for(int r = 0; r <= radius; r++){
                auto current_ring = ring(center, r);
@@ -376,6 +383,7 @@ inline std::vector<Hexagon> spiral(Hexagon center, int radius)
  ******************************************************************************/
 inline Hexagon nearest_hex(Point p)
 {
+        HEX_COUNT("nearest_hex");
         using std::round; using std::sqrt; using std::abs;
         const double a = p.x + 1./sqrt(3.)*p.y, b = 2./sqrt(3.)*p.y;
         const double c = b - a;
@@ -400,16 +408,20 @@ inline Hexagon nearest_hex(Point p)
         
         /***********************************************************************
          * If we have moved the most along a, keep the b and "c" components 
-         * fixed and update the a component to match them. a = -b - c.
+         * fixed and update the a component to match them. a = b - c.
          **********************************************************************/
         if(da > db && da > dc){
-                rounded_a = -rounded_b - rounded_c;
+                HEX_COUNT("nearest_hex.fix_a");
+                rounded_a = rounded_b - rounded_c;
         /***********************************************************************
          * If we have moved the most along b, keep the a and "c" components 
-         * fixed and update the b component to match them. b = -a - c.
+         * fixed and update the b component to match them. b = a + c.
          **********************************************************************/
         }else if(db > dc){
-                rounded_b = -rounded_a - rounded_c;
+                HEX_COUNT("nearest_hex.fix_b");
+                rounded_b = rounded_a + rounded_c;
+        }else{
+                HEX_COUNT("nearest_hex.keep");
         }
         /***********************************************************************
          * If we have moved the most along "c", we should keep a and b constant,
@@ -434,4 +446,17 @@ inline std::ostream& operator<<(std::ostream& os, Hexagon a)
 * @}
 *******************************************************************************/
 }
+
+namespace std{
+template<>
+struct hash<Hex::Hexagon>{
+        size_t operator()(Hex::Hexagon hex) const noexcept
+        {
+                return hash<unsigned long long>()(
+                        (static_cast<unsigned long long>(
+                                static_cast<unsigned int>(hex.a)) << 32) |
+                         static_cast<unsigned int>(hex.b));
+        }
+};
+}
 #endif //HEXAGON_LIBRARY_H
@@ -0,0 +1,324 @@
+#ifndef HEXAGON_INSTRUMENTATION_H
+#define HEXAGON_INSTRUMENTATION_H
+
+/*!*****************************************************************************
+ * \defgroup Instrumentation Instrumentation
+ * Opt-in instrumentation of the library hot paths. Everything here is only
+ * compiled when HEX_INSTRUMENTATION is defined (the CMake option
+ * HEXAGON_INSTRUMENTATION does that for all users of the hexagon target),
+ * otherwise the macros below expand to nothing and their arguments are never
+ * evaluated.
+ *  - HEX_COUNT(name) counts the number of times it is reached.
+ *  - HEX_COUNT_BYTES(name, bytes) adds up allocated bytes, and reports every
+ *    allocation to the sink.
+ *  - HEX_TRACE_SCOPE(name) measures the time until the end of the enclosing
+ *    scope, adds it up and reports it to the sink.
+ * name must be a string literal. Counters are aggregated with atomics and can
+ * be read with Hex::instrumentation::counters(). Events are sent to the sink
+ * set with Hex::instrumentation::set_sink(), e.g. a ChromeTraceSink writing a
+ * trace that can be loaded in chrome://tracing or Perfetto.
+ * @{
+ ******************************************************************************/
+#ifdef HEX_INSTRUMENTATION
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Hex{
+namespace instrumentation{
+/*!*****************************************************************************
+ * Event sent to the sink. value is the allocated number of bytes for
+ * allocations and the duration in nanoseconds for scopes. timestamp is the
+ * time of the allocation, or the start of the scope, in nanoseconds on the
+ * steady clock.
+ ******************************************************************************/
+struct Event{
+        enum class Type{allocation, scope};
+        Type type;
+        const char* name;
+        std::uint64_t value;
+        std::uint64_t timestamp;
+        std::thread::id thread;
+};
+
+using Sink = std::function<void(const Event&)>;
+
+/*!*****************************************************************************
+ * Current value of one counter, as returned by counters().
+ ******************************************************************************/
+struct CounterValue{
+        std::string name;
+        std::string unit;
+        std::uint64_t value;
+};
+
+class Counter;
+
+namespace detail{
+struct Registry{
+        std::mutex mutex;
+        std::vector<Counter*> counters;
+        std::shared_ptr<const Sink> sink;
+};
+
+inline Registry& registry()
+{
+        static Registry res;
+        return res;
+}
+
+inline std::uint64_t now()
+{
+        return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()
+                ).count());
+}
+
+inline void emit(const Event& event)
+{
+        const auto sink = std::atomic_load(&registry().sink);
+        if(sink){
+                (*sink)(event);
+        }
+}
+}
+
+/*!*****************************************************************************
+ * Set the sink receiving all events, an empty Sink disables event reporting
+ * (counters keep counting). Safe to call while other threads emit events.
+ ******************************************************************************/
+inline void set_sink(Sink sink)
+{
+        std::shared_ptr<const Sink> res;
+        if(sink){
+                res = std::make_shared<const Sink>(std::move(sink));
+        }
+        std::atomic_store(&detail::registry().sink, res);
+}
+
+/*!*****************************************************************************
+ * Atomic counter, created once per instrumented call site (as a function local
+ * static) and registered for counters().
+ ******************************************************************************/
+class Counter{
+public:
+        Counter(const char* name, const char* unit)
+         : name_(name), unit_(unit)
+        {
+                auto& registry = detail::registry();
+                std::lock_guard<std::mutex> guard(registry.mutex);
+                registry.counters.push_back(this);
+        }
+
+        void add(std::uint64_t value)
+        {
+                value_.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        CounterValue value() const
+        {
+                return {name_, unit_, value_.load(std::memory_order_relaxed)};
+        }
+
+        void reset()
+        {
+                value_.store(0, std::memory_order_relaxed);
+        }
+
+private:
+        const char* name_;
+        const char* unit_;
+        std::atomic<std::uint64_t> value_{0};
+};
+
+/*!*****************************************************************************
+ * Return the values of all counters reached so far. Counters with the same
+ * name and unit (e.g. from several call sites) are summed.
+ ******************************************************************************/
+inline std::vector<CounterValue> counters()
+{
+        auto& registry = detail::registry();
+        std::lock_guard<std::mutex> guard(registry.mutex);
+        std::vector<CounterValue> res;
+        for(const Counter* counter : registry.counters){
+                const CounterValue value = counter->value();
+                bool merged = false;
+                for(auto& existing : res){
+                        if(existing.name == value.name &&
+                           existing.unit == value.unit){
+                                existing.value += value.value;
+                                merged = true;
+                        }
+                }
+                if(!merged){
+                        res.push_back(value);
+                }
+        }
+        return res;
+}
+
+/*!*****************************************************************************
+ * Return the summed value of the counters with the given name and unit, 0 if
+ * there are none.
+ ******************************************************************************/
+inline std::uint64_t counter(const std::string& name,
+                             const std::string& unit = "calls")
+{
+        for(const auto& value : counters()){
+                if(value.name == name && value.unit == unit){
+                        return value.value;
+                }
+        }
+        return 0;
+}
+
+inline void reset_counters()
+{
+        auto& registry = detail::registry();
+        std::lock_guard<std::mutex> guard(registry.mutex);
+        for(Counter* counter : registry.counters){
+                counter->reset();
+        }
+}
+
+inline void record_allocation(Counter& counter, const char* name,
+                              std::uint64_t bytes)
+{
+        counter.add(bytes);
+        detail::emit({Event::Type::allocation, name, bytes, detail::now(),
+                      std::this_thread::get_id()});
+}
+
+/*!*****************************************************************************
+ * Measure the time between construction and destruction, add it to counter
+ * and report it to the sink.
+ ******************************************************************************/
+class ScopedTimer{
+public:
+        ScopedTimer(Counter& counter, const char* name)
+         : counter_(counter), name_(name), start_(detail::now())
+        {}
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer()
+        {
+                const std::uint64_t duration = detail::now() - start_;
+                counter_.add(duration);
+                detail::emit({Event::Type::scope, name_, duration, start_,
+                              std::this_thread::get_id()});
+        }
+
+private:
+        Counter& counter_;
+        const char* name_;
+        std::uint64_t start_;
+};
+
+/*!*****************************************************************************
+ * Sink writing events in the Chrome trace event format (a JSON array, scopes
+ * as complete events and allocations as counter events) to an ostream. The
+ * stream must outlive the sink, the array is closed when the last copy of the
+ * sink is destroyed.
+ ******************************************************************************/
+class ChromeTraceSink{
+public:
+        explicit ChromeTraceSink(std::ostream& os)
+         : state_(std::make_shared<State>(os))
+        {}
+
+        void operator()(const Event& event) const
+        {
+                const double ts = event.timestamp/1000.;
+                const std::size_t tid =
+                        std::hash<std::thread::id>()(event.thread);
+                // Formatted into a local stream, so the formatting flags of
+                // the caller's stream are left alone.
+                std::ostringstream os;
+                os << "{\"name\": \"" << event.name << "\", \"pid\": 0, "
+                   << "\"tid\": " << tid << ", \"ts\": " << std::fixed << ts;
+                if(event.type == Event::Type::scope){
+                        os << ", \"ph\": \"X\", \"dur\": " << event.value/1000.;
+                }else{
+                        os << ", \"ph\": \"C\", \"args\": {\"bytes\": "
+                           << event.value << "}";
+                }
+                os << "}";
+                std::lock_guard<std::mutex> guard(state_->mutex);
+                state_->os << (state_->first ? "\n" : ",\n") << os.str();
+                state_->first = false;
+        }
+
+private:
+        struct State{
+                explicit State(std::ostream& os)
+                 : os(os)
+                {
+                        os << "[";
+                }
+
+                ~State()
+                {
+                        os << "\n]\n";
+                }
+
+                std::mutex mutex;
+                std::ostream& os;
+                bool first = true;
+        };
+        std::shared_ptr<State> state_;
+};
+}
+}
+
+#define HEX_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define HEX_INSTRUMENTATION_CONCAT(a, b) HEX_INSTRUMENTATION_CONCAT_(a, b)
+#define HEX_INSTRUMENTATION_ID(prefix) \
+        HEX_INSTRUMENTATION_CONCAT(prefix, __LINE__)
+
+#define HEX_COUNT(name) \
+        do{ \
+                static ::Hex::instrumentation::Counter \
+                        hex_instrumentation_counter(name, "calls"); \
+                hex_instrumentation_counter.add(1); \
+        }while(0)
+
+#define HEX_COUNT_BYTES(name, bytes) \
+        do{ \
+                static ::Hex::instrumentation::Counter \
+                        hex_instrumentation_counter(name, "bytes"); \
+                ::Hex::instrumentation::record_allocation( \
+                        hex_instrumentation_counter, name, (bytes)); \
+        }while(0)
+
+#define HEX_TRACE_SCOPE(name) \
+        static ::Hex::instrumentation::Counter \
+                HEX_INSTRUMENTATION_ID(hex_instrumentation_timer_counter_)( \
+                        name, "ns"); \
+        const ::Hex::instrumentation::ScopedTimer \
+                HEX_INSTRUMENTATION_ID(hex_instrumentation_timer_)( \
+                        HEX_INSTRUMENTATION_ID( \
+                                hex_instrumentation_timer_counter_), name)
+
+#else
+
+#define HEX_COUNT(name) do{}while(0)
+#define HEX_COUNT_BYTES(name, bytes) do{}while(0)
+#define HEX_TRACE_SCOPE(name) do{}while(0)
+
+#endif // HEX_INSTRUMENTATION
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+#endif //HEXAGON_INSTRUMENTATION_H
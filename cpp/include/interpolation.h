@@ -0,0 +1,174 @@
+#ifndef HEXAGON_INTERPOLATION_H
+#define HEXAGON_INTERPOLATION_H
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+#include <point.h>
+#include <hexagon.h>
+#include <hex_field.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Interpolation Interpolation
+ * Linear interpolation of per-hexagon values at arbitrary Points.
+ * The hexagon centers form a triangular lattice. Every point lies in one
+ * triangle of three mutually neighbouring centers, made up of the halves of
+ * the Hexagon::wedges() of those three hexagons that face each other.
+ * Values are interpolated with the barycentric weights of the point in that
+ * triangle, giving a continuous field that equals the hexagon value at every
+ * center.
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * The triangle of hexagon centers containing a point, and the barycentric
+ * weights of the point (summing to 1).
+ ******************************************************************************/
+struct HexTriangle{
+        std::array<Hexagon, 3> hexes;
+        std::array<double, 3> weights;
+};
+
+/*!*****************************************************************************
+ * Return the triangle of hexagon centers containing p. The point is converted
+ * to hexagonal coordinates (a, b) and snapped once, to
+ * \f$(\lfloor a \rfloor, \lfloor b \rfloor)\f$. The fractional parts decide
+ * between the two triangles of that lattice cell: (0, 0), (1, 0), (1, 1) if
+ * the a part is the larger one, (0, 0), (0, 1), (1, 1) otherwise.
+ ******************************************************************************/
+inline HexTriangle locate_triangle(Point p)
+{
+        using std::sqrt; using std::floor;
+        const double a = p.x + 1./sqrt(3.)*p.y, b = 2./sqrt(3.)*p.y;
+        const double floor_a = floor(a), floor_b = floor(b);
+        const double fa = a - floor_a, fb = b - floor_b;
+        const Hexagon base{static_cast<int>(floor_a),
+                           static_cast<int>(floor_b)};
+        const bool a_larger = fa >= fb;
+        const double hi = a_larger ? fa : fb, lo = a_larger ? fb : fa;
+        return {{base,
+                 base + (a_larger ? Hexagon{1, 0} : Hexagon{0, 1}),
+                 base + Hexagon{1, 1}},
+                {1 - hi, hi - lo, lo}};
+}
+
+/*!*****************************************************************************
+ * Return the value at p interpolated from value(hex), where value is any
+ * callable taking a Hexagon and returning something convertible to double.
+ ******************************************************************************/
+template<class Lookup>
+double interpolate(const Lookup& value, Point p)
+{
+        const HexTriangle t = locate_triangle(p);
+        return t.weights[0]*value(t.hexes[0]) + t.weights[1]*value(t.hexes[1]) +
+               t.weights[2]*value(t.hexes[2]);
+}
+
+/*!*****************************************************************************
+ * Interpolate value(hex) at the n points (x[i], y[i]) and write the results to
+ * out[i]. Points are processed in fixed size blocks: first the lattice cells
+ * and weights of a whole block are computed in a branch free loop the
+ * compiler can vectorize, then the values are gathered. Nothing is
+ * allocated.
+ ******************************************************************************/
+template<class Lookup>
+void interpolate(const Lookup& value, const double* x, const double* y,
+                 double* out, std::size_t n)
+{
+        constexpr std::size_t block = 64;
+        const double inv_sqrt3 = 1./std::sqrt(3.);
+        int base_a[block], base_b[block], mid_a[block];
+        double w0[block], w1[block], w2[block];
+        for(std::size_t begin = 0; begin < n; begin += block){
+                const std::size_t count = std::min(block, n - begin);
+                for(std::size_t i = 0; i < count; i++){
+                        const double a = x[begin + i] + inv_sqrt3*y[begin + i];
+                        const double b = 2*inv_sqrt3*y[begin + i];
+                        const double floor_a = std::floor(a);
+                        const double floor_b = std::floor(b);
+                        const double fa = a - floor_a, fb = b - floor_b;
+                        const double hi = std::max(fa, fb);
+                        const double lo = std::min(fa, fb);
+                        base_a[i] = static_cast<int>(floor_a);
+                        base_b[i] = static_cast<int>(floor_b);
+                        mid_a[i] = fa >= fb;
+                        w0[i] = 1 - hi;
+                        w1[i] = hi - lo;
+                        w2[i] = lo;
+                }
+                for(std::size_t i = 0; i < count; i++){
+                        const Hexagon base{base_a[i], base_b[i]};
+                        const Hexagon mid{mid_a[i], 1 - mid_a[i]};
+                        out[begin + i] = w0[i]*value(base) +
+                                         w1[i]*value(base + mid) +
+                                         w2[i]*value(base + Hexagon{1, 1});
+                }
+        }
+}
+
+/*!*****************************************************************************
+ * Interpolate value(hex) at the n points and write the results to out[i].
+ ******************************************************************************/
+template<class Lookup>
+void interpolate(const Lookup& value, const Point* points, double* out,
+                 std::size_t n)
+{
+        constexpr std::size_t block = 64;
+        double x[block], y[block];
+        for(std::size_t begin = 0; begin < n; begin += block){
+                const std::size_t count = std::min(block, n - begin);
+                for(std::size_t i = 0; i < count; i++){
+                        x[i] = points[begin + i].x;
+                        y[i] = points[begin + i].y;
+                }
+                interpolate(value, x, y, out + begin, count);
+        }
+}
+
+/*!*****************************************************************************
+ * Lookup of the values of a HexField, hexagons outside the field take the
+ * value of the closest hexagon (in a and b separately) inside it.
+ ******************************************************************************/
+template<class T>
+struct ClampedLookup{
+        const HexField<T>& field;
+
+        double operator()(Hexagon hex) const
+        {
+                const Hexagon origin = field.origin();
+                hex.a = std::min(std::max(hex.a, origin.a),
+                                 origin.a + field.width() - 1);
+                hex.b = std::min(std::max(hex.b, origin.b),
+                                 origin.b + field.height() - 1);
+                return static_cast<double>(field[hex]);
+        }
+};
+
+template<class T>
+double interpolate(const HexField<T>& field, Point p)
+{
+        const ClampedLookup<T> lookup{field};
+        return interpolate(lookup, p);
+}
+
+template<class T>
+void interpolate(const HexField<T>& field, const double* x, const double* y,
+                 double* out, std::size_t n)
+{
+        const ClampedLookup<T> lookup{field};
+        interpolate(lookup, x, y, out, n);
+}
+
+template<class T>
+void interpolate(const HexField<T>& field, const Point* points, double* out,
+                 std::size_t n)
+{
+        const ClampedLookup<T> lookup{field};
+        interpolate(lookup, points, out, n);
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_INTERPOLATION_H
@@ -0,0 +1,149 @@
+#ifndef HEXAGON_OUTLINE_H
+#define HEXAGON_OUTLINE_H
+
+#include <array>
+#include <vector>
+#include <unordered_set>
+
+#include <point.h>
+#include <hexagon.h>
+#include <polyline.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Outline Outline
+ * Boundary extraction for regions of hexagons. The boundary is traced in
+ * integer hexagonal coordinates, a boundary side is a pair (hex, direction)
+ * with hex inside the region and hex + neighbor_directions[direction]
+ * outside. The side facing neighbor_directions[i] runs from
+ * corners()[(i + 5) % 6] to corners()[i].
+ * Points are only computed for the output, so no floating point comparisons
+ * are needed to match up shared Edges.
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * A closed boundary of a region. Outer boundaries run counter-clockwise and
+ * holes clockwise, so the region is always to the left of the boundary.
+ ******************************************************************************/
+struct Outline{
+        Polyline boundary;
+        bool hole = false;
+};
+
+namespace detail{
+/*!*****************************************************************************
+ * Offsets from the center of a Hexagon to its corners, same order as
+ * Hexagon::corners().
+ ******************************************************************************/
+inline const std::array<Point, 6>& corner_offsets()
+{
+        static const std::array<Point, 6> res = Hexagon{0, 0}.corners();
+        return res;
+}
+
+/*!*****************************************************************************
+ * Walk the closed boundary containing the side (start, direction), calling
+ * visit(hex, direction) for every side in order. Returns the number of left
+ * turns minus the number of right turns (6 for outer boundaries, -6 for
+ * holes).
+ ******************************************************************************/
+template<class Inside, class Visit>
+int walk_boundary(Hexagon start, int direction, Inside& inside, Visit visit)
+{
+        Hexagon hex = start;
+        int dir = direction, turns = 0;
+        do{
+                visit(hex, dir);
+                // The corner at the end of this side is shared by hex,
+                // hex + d[dir] (outside) and hex + d[dir + 1].
+                const Hexagon next = hex + neighbor_directions[(dir + 1) % 6];
+                if(inside(next)){
+                        hex = next;
+                        dir = (dir + 5) % 6;
+                        turns--;
+                }else{
+                        dir = (dir + 1) % 6;
+                        turns++;
+                }
+        }while(hex != start || dir != direction);
+        return turns;
+}
+}
+
+/*!*****************************************************************************
+ * Trace the closed boundary through the side of start facing
+ * neighbor_directions[direction]. start must satisfy inside(start), and the
+ * neighbour in direction must not. Runs in time linear in the length of the
+ * boundary, inside is only called for cells next to it.
+ * visit(hex, direction) is called for every side of the boundary.
+ ******************************************************************************/
+template<class Inside, class Visit>
+Outline trace_outline(Hexagon start, int direction, Inside inside, Visit visit)
+{
+        Outline res;
+        res.boundary.closed = true;
+        const auto& offsets = detail::corner_offsets();
+        const int turns = detail::walk_boundary(start, direction, inside,
+                [&res, &offsets, &visit](Hexagon hex, int dir)
+                {
+                        visit(hex, dir);
+                        res.boundary.points.push_back(
+                                hex.to_point() + offsets[(dir + 5) % 6]);
+                });
+        res.hole = turns < 0;
+        return res;
+}
+
+template<class Inside>
+Outline trace_outline(Hexagon start, int direction, Inside inside)
+{
+        return trace_outline(start, direction, inside, [](Hexagon, int){});
+}
+
+/*!*****************************************************************************
+ * Return all boundaries (outer boundaries and holes) of the region given by
+ * inside, restricted to the connected parts containing at least one of cells.
+ * cells should list the region (or at least its boundary cells); every
+ * boundary is traced once.
+ ******************************************************************************/
+template<class Inside>
+std::vector<Outline> outlines(const std::vector<Hexagon>& cells, Inside inside)
+{
+        std::vector<Outline> res;
+        std::array<std::unordered_set<Hexagon>, 6> visited;
+        for(const auto& hex : cells){
+                if(!inside(hex)){
+                        continue;
+                }
+                for(int dir = 0; dir < 6; dir++){
+                        if(inside(hex + neighbor_directions[dir]) ||
+                           visited[dir].count(hex)){
+                                continue;
+                        }
+                        res.push_back(trace_outline(hex, dir, inside,
+                                [&visited](Hexagon h, int d)
+                                {
+                                        visited[d].insert(h);
+                                }));
+                }
+        }
+        return res;
+}
+
+/*!*****************************************************************************
+ * Return all boundaries (outer boundaries and holes) of the set of hexagons
+ * cells.
+ ******************************************************************************/
+inline std::vector<Outline> outlines(const std::unordered_set<Hexagon>& cells)
+{
+        const std::vector<Hexagon> list(cells.begin(), cells.end());
+        return outlines(list, [&cells](Hexagon hex)
+                              {
+                                      return cells.count(hex) > 0;
+                              });
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_OUTLINE_H
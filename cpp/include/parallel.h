@@ -0,0 +1,69 @@
+#ifndef HEXAGON_PARALLEL_H
+#define HEXAGON_PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Parallel Parallel
+ * Minimal helpers for splitting work over std::threads.
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Return num_threads, or the number of hardware threads if num_threads is 0.
+ ******************************************************************************/
+inline unsigned thread_count(unsigned num_threads = 0)
+{
+        if(num_threads > 0){
+                return num_threads;
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/*!*****************************************************************************
+ * Split [0, n) into num_threads contiguous blocks (num_threads = 0 means one
+ * per hardware thread) and call f(begin, end, thread_index) for each block on
+ * its own thread. Returns when all blocks are done. With a single block, f is
+ * called on the calling thread.
+ ******************************************************************************/
+template<class F>
+void parallel_blocks(std::size_t n, unsigned num_threads, F f)
+{
+        const std::size_t blocks = std::max<std::size_t>(
+                1, std::min<std::size_t>(thread_count(num_threads), n));
+        if(blocks == 1){
+                f(std::size_t{0}, n, 0u);
+                return;
+        }
+        std::vector<std::thread> threads;
+        threads.reserve(blocks);
+        for(std::size_t t = 0; t < blocks; t++){
+                threads.emplace_back(f, n*t/blocks, n*(t + 1)/blocks,
+                                     static_cast<unsigned>(t));
+        }
+        for(auto& thread : threads){
+                thread.join();
+        }
+}
+
+/*!*****************************************************************************
+ * Call f(i) for all i in [0, n), split over num_threads threads.
+ ******************************************************************************/
+template<class F>
+void parallel_for(std::size_t n, unsigned num_threads, F f)
+{
+        parallel_blocks(n, num_threads,
+                        [&f](std::size_t begin, std::size_t end, unsigned)
+                        {
+                                for(std::size_t i = begin; i < end; i++){
+                                        f(i);
+                                }
+                        });
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_PARALLEL_H
@@ -0,0 +1,320 @@
+#ifndef HEXAGON_PARTITION_H
+#define HEXAGON_PARTITION_H
+
+#include <map>
+#include <deque>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <condition_variable>
+
+#include <hexagon.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Partition Partition
+ * Domain decomposition of a region of hexagons for distributed simulations.
+ * Each part (rank) owns a set of cells and keeps ghost copies of the
+ * neighbouring cells owned by other ranks, which are refreshed by a halo
+ * exchange through a HaloTransport.
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * The cells shared with one neighbouring rank. send lists the owned cells the
+ * neighbour keeps ghost copies of, receive the neighbour's cells kept as
+ * ghosts here. Both are sorted by (b, a), so the send list of one rank
+ * matches the receive list of the other cell by cell.
+ ******************************************************************************/
+struct Halo{
+        int neighbor = -1;
+        std::vector<Hexagon> send;
+        std::vector<Hexagon> receive;
+};
+
+struct Subdomain{
+        int rank = -1;
+        /*!*********************************************************************
+         * Owned cells, sorted by (b, a).
+         **********************************************************************/
+        std::vector<Hexagon> cells;
+        /*!*********************************************************************
+         * One entry per neighbouring rank, sorted by rank.
+         **********************************************************************/
+        std::vector<Halo> halos;
+};
+
+namespace detail{
+inline bool row_order(Hexagon x, Hexagon y)
+{
+        return x.b < y.b || (x.b == y.b && x.a < y.a);
+}
+
+/*!*****************************************************************************
+ * Recursive coordinate bisection of cells[begin, end) into parts parts,
+ * numbered from first_rank. Each split is along the longest of the three
+ * hexagonal axes a, b and c = b - a, at the cell count proportional to the
+ * number of parts on either side.
+ ******************************************************************************/
+inline void bisect(std::vector<Hexagon>& cells, std::size_t begin,
+                   std::size_t end, int parts, int first_rank,
+                   std::vector<int>& ranks)
+{
+        if(parts == 1){
+                std::fill(ranks.begin() + begin, ranks.begin() + end,
+                          first_rank);
+                return;
+        }
+        const auto coordinate = [](Hexagon hex, int axis)
+                                {
+                                        return axis == 0 ? hex.a :
+                                               axis == 1 ? hex.b :
+                                                           hex.b - hex.a;
+                                };
+        int axis = 0, extent = -1;
+        for(int k = 0; k < 3; k++){
+                const auto range = std::minmax_element(
+                        cells.begin() + begin, cells.begin() + end,
+                        [&](Hexagon x, Hexagon y)
+                        {
+                                return coordinate(x, k) < coordinate(y, k);
+                        });
+                const int e = coordinate(*range.second, k) -
+                              coordinate(*range.first, k);
+                if(e > extent){
+                        extent = e;
+                        axis = k;
+                }
+        }
+        const int lower = parts/2;
+        const std::size_t middle = begin + (end - begin)*lower/parts;
+        std::nth_element(cells.begin() + begin, cells.begin() + middle,
+                         cells.begin() + end,
+                         [&](Hexagon x, Hexagon y)
+                         {
+                                 const int cx = coordinate(x, axis);
+                                 const int cy = coordinate(y, axis);
+                                 return cx < cy ||
+                                        (cx == cy && row_order(x, y));
+                         });
+        bisect(cells, begin, middle, lower, first_rank, ranks);
+        bisect(cells, middle, end, parts - lower, first_rank + lower, ranks);
+}
+}
+
+/*!*****************************************************************************
+ * Split of a region of hexagons into balanced, compact subdomains by
+ * recursive coordinate bisection. Part sizes differ by at most one cell per
+ * level of bisection. Halos are the cells across the neighbor_directions of
+ * each owned cell.
+ ******************************************************************************/
+class Partition{
+public:
+        Partition(std::vector<Hexagon> cells, int parts)
+        {
+                if(parts < 1){
+                        throw std::invalid_argument(
+                                "Partition: need at least one part");
+                }
+                std::sort(cells.begin(), cells.end(), detail::row_order);
+                cells.erase(std::unique(cells.begin(), cells.end()),
+                            cells.end());
+                std::vector<int> ranks(cells.size());
+                detail::bisect(cells, 0, cells.size(), parts, 0, ranks);
+
+                subdomains_.resize(parts);
+                owner_.reserve(cells.size());
+                for(std::size_t i = 0; i < cells.size(); i++){
+                        owner_.emplace(cells[i], ranks[i]);
+                        subdomains_[ranks[i]].cells.push_back(cells[i]);
+                }
+                for(int rank = 0; rank < parts; rank++){
+                        Subdomain& subdomain = subdomains_[rank];
+                        subdomain.rank = rank;
+                        std::sort(subdomain.cells.begin(), subdomain.cells.end(),
+                                  detail::row_order);
+                        build_halos(subdomain);
+                }
+        }
+
+        int parts() const
+        {
+                return static_cast<int>(subdomains_.size());
+        }
+
+        /*!*********************************************************************
+         * Return the rank owning hex, or -1 if hex is outside the region.
+         **********************************************************************/
+        int owner(Hexagon hex) const
+        {
+                const auto it = owner_.find(hex);
+                return it == owner_.end() ? -1 : it->second;
+        }
+
+        const Subdomain& subdomain(int rank) const
+        {
+                return subdomains_.at(rank);
+        }
+
+private:
+        std::unordered_map<Hexagon, int> owner_;
+        std::vector<Subdomain> subdomains_;
+
+        void build_halos(Subdomain& subdomain)
+        {
+                std::map<int, Halo> halos;
+                for(const auto& hex : subdomain.cells){
+                        for(const auto& dir : neighbor_directions){
+                                const int rank = owner(hex + dir);
+                                if(rank < 0 || rank == subdomain.rank){
+                                        continue;
+                                }
+                                Halo& halo = halos[rank];
+                                halo.neighbor = rank;
+                                halo.send.push_back(hex);
+                                halo.receive.push_back(hex + dir);
+                        }
+                }
+                for(auto& entry : halos){
+                        Halo& halo = entry.second;
+                        for(auto* list : {&halo.send, &halo.receive}){
+                                std::sort(list->begin(), list->end(),
+                                          detail::row_order);
+                                list->erase(std::unique(list->begin(),
+                                                        list->end()),
+                                            list->end());
+                        }
+                        subdomain.halos.push_back(std::move(halo));
+                }
+        }
+};
+
+/*!*****************************************************************************
+ * Point to point message passing between ranks. Messages between a pair of
+ * ranks must arrive in the order they were sent. exchange_halo() sends all
+ * halos before receiving any, so send must not block until the message is
+ * received, or neighbouring ranks deadlock. An MPI implementation can post
+ * MPI_Isend requests and complete them after the receives, or use buffered
+ * sends, with the ranks as source and destination.
+ ******************************************************************************/
+class HaloTransport{
+public:
+        virtual ~HaloTransport() = default;
+
+        /*!*********************************************************************
+         * Queue message from from to to and return without waiting for it to
+         * be received.
+         **********************************************************************/
+        virtual void send(int from, int to, std::vector<std::uint8_t> message) = 0;
+
+        /*!*********************************************************************
+         * Block until a message from from to to is available and return it.
+         **********************************************************************/
+        virtual std::vector<std::uint8_t> receive(int to, int from) = 0;
+};
+
+/*!*****************************************************************************
+ * In-process transport, for ranks running as threads of one process: one
+ * queue of messages per (from, to) pair, guarded by a mutex.
+ ******************************************************************************/
+class MailboxTransport : public HaloTransport{
+public:
+        void send(int from, int to, std::vector<std::uint8_t> message) override
+        {
+                {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        mailboxes_[{from, to}].push_back(std::move(message));
+                }
+                arrived_.notify_all();
+        }
+
+        std::vector<std::uint8_t> receive(int to, int from) override
+        {
+                std::unique_lock<std::mutex> lock(mutex_);
+                auto& mailbox = mailboxes_[{from, to}];
+                // Timed waits in a loop rather than wait(), which needs a
+                // newer libstdc++ runtime (GLIBCXX_3.4.30) than the timed
+                // waits do. The predicate wait still wakes on notify_all,
+                // the timeout only adds a periodic re-check.
+                while(!arrived_.wait_for(lock, std::chrono::seconds(1),
+                                         [&mailbox]{ return !mailbox.empty(); })){
+                }
+                std::vector<std::uint8_t> res = std::move(mailbox.front());
+                mailbox.pop_front();
+                return res;
+        }
+
+private:
+        std::mutex mutex_;
+        std::condition_variable arrived_;
+        std::map<std::pair<int, int>, std::deque<std::vector<std::uint8_t>>>
+                mailboxes_;
+};
+
+/*!*****************************************************************************
+ * Return the values get(hex) of cells, copied into a byte buffer.
+ ******************************************************************************/
+template<class T, class Get>
+std::vector<std::uint8_t> pack_halo(const std::vector<Hexagon>& cells, Get get)
+{
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "pack_halo: T must be trivially copyable");
+        std::vector<std::uint8_t> res(cells.size()*sizeof(T));
+        for(std::size_t i = 0; i < cells.size(); i++){
+                const T value = get(cells[i]);
+                std::memcpy(res.data() + i*sizeof(T), &value, sizeof(T));
+        }
+        return res;
+}
+
+/*!*****************************************************************************
+ * Call set(cells[i], value i) for the values packed in buffer by pack_halo.
+ * Throws std::invalid_argument if the buffer does not hold one value per
+ * cell.
+ ******************************************************************************/
+template<class T, class Set>
+void unpack_halo(const std::vector<Hexagon>& cells,
+                 const std::vector<std::uint8_t>& buffer, Set set)
+{
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "unpack_halo: T must be trivially copyable");
+        if(buffer.size() != cells.size()*sizeof(T)){
+                throw std::invalid_argument("unpack_halo: size mismatch");
+        }
+        for(std::size_t i = 0; i < cells.size(); i++){
+                T value;
+                std::memcpy(&value, buffer.data() + i*sizeof(T), sizeof(T));
+                set(cells[i], value);
+        }
+}
+
+/*!*****************************************************************************
+ * Refresh the ghost cells of subdomain: send get(hex) for the send list of
+ * every halo, then receive the neighbours' values and store them with
+ * set(hex, value). Every rank has to call this for the exchange to complete.
+ ******************************************************************************/
+template<class T, class Get, class Set>
+void exchange_halo(const Subdomain& subdomain, HaloTransport& transport,
+                   Get get, Set set)
+{
+        for(const auto& halo : subdomain.halos){
+                transport.send(subdomain.rank, halo.neighbor,
+                               pack_halo<T>(halo.send, get));
+        }
+        for(const auto& halo : subdomain.halos){
+                unpack_halo<T>(halo.receive,
+                               transport.receive(subdomain.rank, halo.neighbor),
+                               set);
+        }
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_PARTITION_H
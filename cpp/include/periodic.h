@@ -0,0 +1,296 @@
+#ifndef HEXAGON_PERIODIC_H
+#define HEXAGON_PERIODIC_H
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <hexagon.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Periodic Periodic
+ * @{
+ ******************************************************************************/
+namespace detail{
+/*!*****************************************************************************
+ * Integer division rounding towards negative infinity, d > 0.
+ ******************************************************************************/
+inline int floor_div(int n, int d)
+{
+        return n >= 0 ? n/d : -((-n + d - 1)/d);
+}
+
+/*!*****************************************************************************
+ * Return 4 times the inner product of x.to_point() and y.to_point(), exact in
+ * integers.
+ ******************************************************************************/
+inline long long dot4(Hexagon x, Hexagon y)
+{
+        const long long xa = x.a, xb = x.b, ya = y.a, yb = y.b;
+        return 2*(2*xa*ya + 2*xb*yb - xa*yb - ya*xb);
+}
+
+/*!*****************************************************************************
+ * Return the integer nearest to n/d, d > 0.
+ ******************************************************************************/
+inline long long round_div(long long n, long long d)
+{
+        const long long t = 2*n + d, q = 2*d;
+        return t >= 0 ? t/q : -((-t + q - 1)/q);
+}
+}
+
+/*!*****************************************************************************
+ * Hexagonal grid wrapped around a torus: hexagons differing by an integer
+ * combination of two wrap vectors are the same cell. The lattice of wrap
+ * vectors is brought to Hermite normal form, with basis (width, 0) and
+ * (shift, height), \f$0 \le shift < width\f$. Every hexagon then has exactly
+ * one equivalent in the fundamental domain \f$0 \le a < width\f$,
+ * \f$0 \le b < height\f$, its canonical form. Canonical cells are indexed
+ * a + width*b, the storage order of a HexField(Hexagon{0, 0}, width(),
+ * height()), so such a field holds one value per cell of the domain.
+ * Neighbour indices are precomputed, so stencil loops need no wrapping
+ * logic.
+ ******************************************************************************/
+class PeriodicHexDomain{
+public:
+        /*!*********************************************************************
+         * Create the domain wrapping around u and v, which must be linearly
+         * independent.
+         **********************************************************************/
+        PeriodicHexDomain(Hexagon u, Hexagon v)
+        {
+                // Euclid on the b components: ends with v.b == 0.
+                while(v.b != 0){
+                        const int q = u.b/v.b;
+                        u = u - v*q;
+                        std::swap(u, v);
+                }
+                if(u.b == 0 || v.a == 0){
+                        throw std::invalid_argument(
+                                "PeriodicHexDomain: wrap vectors are linearly "
+                                "dependent");
+                }
+                if(u.b < 0){
+                        u = -u;
+                }
+                width_ = std::abs(v.a);
+                height_ = u.b;
+                shift_ = u.a - width_*detail::floor_div(u.a, width_);
+                reduce_basis();
+                build_neighbors();
+        }
+
+        int width() const
+        {
+                return width_;
+        }
+
+        int height() const
+        {
+                return height_;
+        }
+
+        /*!*********************************************************************
+         * a coordinate of the wrap vector (shift(), height()).
+         **********************************************************************/
+        int shift() const
+        {
+                return shift_;
+        }
+
+        /*!*********************************************************************
+         * Return the number of cells in the domain.
+         **********************************************************************/
+        std::size_t size() const
+        {
+                return static_cast<std::size_t>(width_)*height_;
+        }
+
+        /*!*********************************************************************
+         * Return the equivalent of hex inside the fundamental domain.
+         **********************************************************************/
+        Hexagon canonical(Hexagon hex) const
+        {
+                const int k = detail::floor_div(hex.b, height_);
+                const int a = hex.a - k*shift_;
+                return {a - width_*detail::floor_div(a, width_),
+                        hex.b - k*height_};
+        }
+
+        /*!*********************************************************************
+         * Return the index of the cell of hex (any hexagon, not necessarily
+         * canonical).
+         **********************************************************************/
+        std::size_t index(Hexagon hex) const
+        {
+                const Hexagon c = canonical(hex);
+                return static_cast<std::size_t>(c.a) +
+                       static_cast<std::size_t>(width_)*c.b;
+        }
+
+        /*!*********************************************************************
+         * Return the canonical hexagon of cell i.
+         **********************************************************************/
+        Hexagon hex(std::size_t i) const
+        {
+                return {static_cast<int>(i % width_),
+                        static_cast<int>(i / width_)};
+        }
+
+        /*!*********************************************************************
+         * Return the index of the neighbour of cell i in
+         * neighbor_directions[direction]. A table lookup.
+         **********************************************************************/
+        std::uint32_t neighbor(std::size_t i, int direction) const
+        {
+                return neighbors_[6*i + direction];
+        }
+
+        /*!*********************************************************************
+         * The neighbour table, the neighbours of cell i in the order of
+         * neighbor_directions are at [6 i, 6 i + 6).
+         **********************************************************************/
+        const std::vector<std::uint32_t>& neighbor_table() const
+        {
+                return neighbors_;
+        }
+
+        /*!*********************************************************************
+         * Return the shortest vector from p to (an image of) q.
+         **********************************************************************/
+        Hexagon displacement(Hexagon p, Hexagon q) const
+        {
+                Hexagon d = q - p;
+                // Round to the nearest lattice point in the reduced basis,
+                // then search the lattice points around it.
+                const double x = (d.a*static_cast<double>(basis_[1].b) -
+                                  d.b*static_cast<double>(basis_[1].a))/det_;
+                const double y = (d.b*static_cast<double>(basis_[0].a) -
+                                  d.a*static_cast<double>(basis_[0].b))/det_;
+                d = d - basis_[0]*static_cast<int>(std::lround(x)) -
+                    basis_[1]*static_cast<int>(std::lround(y));
+                Hexagon best = d;
+                int best_distance = manhattan_distance(d);
+                for(int i = -2; i <= 2; i++){
+                        for(int j = -2; j <= 2; j++){
+                                const Hexagon candidate =
+                                        d + basis_[0]*i + basis_[1]*j;
+                                const int distance =
+                                        manhattan_distance(candidate);
+                                if(distance < best_distance){
+                                        best = candidate;
+                                        best_distance = distance;
+                                }
+                        }
+                }
+                return best;
+        }
+
+        /*!*********************************************************************
+         * Return the number of steps between p and q on the wrapped grid.
+         **********************************************************************/
+        int distance(Hexagon p, Hexagon q) const
+        {
+                return manhattan_distance(displacement(p, q));
+        }
+
+        /*!*********************************************************************
+         * Return the canonical cells at wrapped distance radius from center,
+         * each once, in the order of ring(center, radius). Once the ring is
+         * larger than the domain it wraps onto itself and holds fewer than
+         * 6 radius cells.
+         **********************************************************************/
+        std::vector<Hexagon> ring(Hexagon center, int radius) const
+        {
+                return wrapped(Hex::ring(center, radius), center, radius, false);
+        }
+
+        /*!*********************************************************************
+         * Return the canonical cells within wrapped distance radius from
+         * center, each once, nearest first.
+         **********************************************************************/
+        std::vector<Hexagon> spiral(Hexagon center, int radius) const
+        {
+                return wrapped(Hex::spiral(center, radius), center, radius, true);
+        }
+
+private:
+        int width_ = 0, height_ = 0, shift_ = 0;
+        std::array<Hexagon, 2> basis_;
+        double det_ = 0;
+        std::vector<std::uint32_t> neighbors_;
+
+        /*!*********************************************************************
+         * Lagrange-Gauss reduction of the wrap lattice basis (in the plane),
+         * for the nearest image search in displacement().
+         **********************************************************************/
+        void reduce_basis()
+        {
+                Hexagon r1{width_, 0}, r2{shift_, height_};
+                if(detail::dot4(r1, r1) > detail::dot4(r2, r2)){
+                        std::swap(r1, r2);
+                }
+                // Exact integer arithmetic, and a stop as soon as the shorter
+                // vector does not get strictly shorter, so rounding ties can
+                // not make the reduction cycle.
+                while(true){
+                        const long long mu = detail::round_div(
+                                detail::dot4(r1, r2), detail::dot4(r1, r1));
+                        r2 = r2 - r1*static_cast<int>(mu);
+                        if(detail::dot4(r2, r2) >= detail::dot4(r1, r1)){
+                                break;
+                        }
+                        std::swap(r1, r2);
+                }
+                basis_ = {r1, r2};
+                det_ = static_cast<double>(r1.a)*r2.b -
+                       static_cast<double>(r1.b)*r2.a;
+        }
+
+        void build_neighbors()
+        {
+                if(size() > std::numeric_limits<std::uint32_t>::max()){
+                        throw std::length_error(
+                                "PeriodicHexDomain: too many cells");
+                }
+                neighbors_.resize(6*size());
+                for(std::size_t i = 0; i < size(); i++){
+                        const Hexagon h = hex(i);
+                        for(int dir = 0; dir < 6; dir++){
+                                neighbors_[6*i + dir] = static_cast<std::uint32_t>(
+                                        index(h + neighbor_directions[dir]));
+                        }
+                }
+        }
+
+        std::vector<Hexagon> wrapped(const std::vector<Hexagon>& hexes,
+                                     Hexagon center, int radius,
+                                     bool within) const
+        {
+                std::vector<Hexagon> res;
+                std::unordered_set<Hexagon> seen;
+                for(const auto& hex : hexes){
+                        const Hexagon c = canonical(hex);
+                        if(!seen.insert(c).second){
+                                continue;
+                        }
+                        const int d = distance(center, c);
+                        if(d == radius || (within && d < radius)){
+                                res.push_back(c);
+                        }
+                }
+                return res;
+        }
+};
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_PERIODIC_H
@@ -9,7 +9,7 @@ namespace Hex{
  * lattice vectors).
 *******************************************************************************/
 struct Point{
-        double x, y;
+        double x = 0, y = 0;
 
         /*!*********************************************************************
          * Component-wise addition assignment of the cartesian coordinates.
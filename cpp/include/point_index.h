@@ -0,0 +1,327 @@
+#ifndef HEXAGON_POINT_INDEX_H
+#define HEXAGON_POINT_INDEX_H
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <point.h>
+#include <hexagon.h>
+#include <parallel.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup PointIndex PointIndex
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Spatial index for radius and k-nearest neighbour queries over a set of
+ * Points. Every point is bucketed into the hexagon nearest_hex(p/cell_size),
+ * i.e. a hexagonal lattice with center spacing cell_size. The buckets are
+ * stored in compressed sparse row (CSR) form: all points sorted by bucket in
+ * one array, plus an offset array over the parallelogram in (a, b) space
+ * bounding all occupied hexagons.
+ * Queries walk ring() around the hexagon of the query point, skipping cells
+ * whose euclidean lower bound is too large, and stop as soon as no point
+ * further out can matter.
+ * Choose cell_size close to the typical query radius (or the typical k-th
+ * neighbour distance). The offset array grows with the area of the bounding
+ * parallelogram, so the index suits reasonably uniform point densities.
+ ******************************************************************************/
+class PointIndex{
+public:
+        /*!*********************************************************************
+         * Build the index over points, using num_threads threads (0 means one
+         * per hardware thread). Throws std::invalid_argument unless
+         * cell_size is positive and finite.
+         **********************************************************************/
+        PointIndex(const std::vector<Point>& points, double cell_size,
+                   unsigned num_threads = 0)
+         : cell_size_(cell_size)
+        {
+                if(!(cell_size > 0) || std::isinf(cell_size)){
+                        throw std::invalid_argument(
+                                "PointIndex: cell_size must be positive and "
+                                "finite");
+                }
+                build(points, num_threads);
+        }
+
+        /*!*********************************************************************
+         * Return the indices (into the points given at construction) of all
+         * points at most radius away from q, in no particular order. An
+         * infinite radius returns all points.
+         **********************************************************************/
+        std::vector<std::size_t> radius_query(Point q, double radius) const
+        {
+                std::vector<std::size_t> res;
+                if(points_.empty()){
+                        return res;
+                }
+                const Point ql = q/cell_size_;
+                const Hexagon center = nearest_hex(ql);
+                const double r = radius/cell_size_, r2 = radius*radius;
+                // Clamped in floating point, huge or infinite radii do not fit
+                // in an int.
+                const int last_ring = max_ring_from(center);
+                const double rings =
+                        std::ceil((r + 2*circumradius)/inradius_step) + 1;
+                const int max_ring = rings < last_ring ?
+                                     static_cast<int>(rings) : last_ring;
+                for(int k = 0; k <= max_ring; k++){
+                        for(const auto& hex : ring(center, k)){
+                                const std::size_t cell = cell_index(hex);
+                                if(cell == npos ||
+                                   lower_bound(hex, ql) > r){
+                                        continue;
+                                }
+                                for(std::size_t i = offsets_[cell];
+                                    i < offsets_[cell + 1]; i++){
+                                        if(distance2(points_[i], q) <= r2){
+                                                res.push_back(ids_[i]);
+                                        }
+                                }
+                        }
+                }
+                return res;
+        }
+
+        /*!*********************************************************************
+         * Return the indices (into the points given at construction) of the
+         * k points closest to q, sorted by increasing distance. Returns fewer
+         * than k indices if the index holds fewer than k points.
+         **********************************************************************/
+        std::vector<std::size_t> nearest(Point q, std::size_t k) const
+        {
+                using entry = std::pair<double, std::size_t>;
+                std::priority_queue<entry> best; // max-heap on distance^2
+                if(k == 0 || points_.empty()){
+                        return {};
+                }
+                const Point ql = q/cell_size_;
+                const Hexagon center = nearest_hex(ql);
+                const int last_ring = max_ring_from(center);
+                std::vector<std::pair<double, Hexagon>> cells;
+                for(int ring_index = 0; ring_index <= last_ring; ring_index++){
+                        const double ring_bound = cell_size_*std::max(
+                                0., ring_index*inradius_step - 2*circumradius);
+                        if(best.size() == k &&
+                           ring_bound*ring_bound > best.top().first){
+                                break;
+                        }
+                        cells.clear();
+                        for(const auto& hex : ring(center, ring_index)){
+                                if(cell_index(hex) != npos){
+                                        cells.push_back(
+                                                {lower_bound(hex, ql), hex});
+                                }
+                        }
+                        std::sort(cells.begin(), cells.end(),
+                                  [](const std::pair<double, Hexagon>& a,
+                                     const std::pair<double, Hexagon>& b)
+                                  {
+                                          return a.first < b.first;
+                                  });
+                        for(const auto& c : cells){
+                                const double bound = c.first*cell_size_;
+                                if(best.size() == k &&
+                                   bound*bound > best.top().first){
+                                        break;
+                                }
+                                const std::size_t cell = cell_index(c.second);
+                                for(std::size_t i = offsets_[cell];
+                                    i < offsets_[cell + 1]; i++){
+                                        const double d2 = distance2(points_[i],
+                                                                    q);
+                                        if(best.size() < k){
+                                                best.push({d2, ids_[i]});
+                                        }else if(d2 < best.top().first){
+                                                best.pop();
+                                                best.push({d2, ids_[i]});
+                                        }
+                                }
+                        }
+                }
+                std::vector<std::size_t> res(best.size());
+                for(auto it = res.rbegin(); it != res.rend(); ++it){
+                        *it = best.top().second;
+                        best.pop();
+                }
+                return res;
+        }
+
+        std::size_t size() const
+        {
+                return points_.size();
+        }
+
+        double cell_size() const
+        {
+                return cell_size_;
+        }
+
+private:
+        static constexpr std::size_t npos =
+                std::numeric_limits<std::size_t>::max();
+        /*!*********************************************************************
+         * Distance from a hexagon center to its corners, and the smallest
+         * distance between the center hexagon and the centers on ring k
+         * (per ring), in lattice units.
+         **********************************************************************/
+        static constexpr double circumradius = 0.57735026918962576;
+        static constexpr double inradius_step = 0.86602540378443865;
+
+        double cell_size_;
+        Hexagon min_, max_;
+        int width_ = 0;
+        std::vector<std::size_t> offsets_;
+        std::vector<Point> points_;
+        std::vector<std::size_t> ids_;
+
+        static double distance2(Point a, Point b)
+        {
+                const Point d = a - b;
+                return d.x*d.x + d.y*d.y;
+        }
+
+        /*!*********************************************************************
+         * Lower bound of the distance (in lattice units) from q to any point
+         * inside hex.
+         **********************************************************************/
+        static double lower_bound(Hexagon hex, Point q)
+        {
+                return std::max(0., std::sqrt(distance2(hex.to_point(), q)) -
+                                    circumradius);
+        }
+
+        std::size_t cell_index(Hexagon hex) const
+        {
+                if(hex.a < min_.a || hex.a > max_.a ||
+                   hex.b < min_.b || hex.b > max_.b){
+                        return npos;
+                }
+                return static_cast<std::size_t>(hex.a - min_.a) +
+                       static_cast<std::size_t>(width_)*(hex.b - min_.b);
+        }
+
+        /*!*********************************************************************
+         * Return the radius of the last ring around center that can contain
+         * occupied cells.
+         **********************************************************************/
+        int max_ring_from(Hexagon center) const
+        {
+                int res = 0;
+                for(const auto& corner : {min_, max_, Hexagon{min_.a, max_.b},
+                                          Hexagon{max_.a, min_.b}}){
+                        res = std::max(res, manhattan_distance(corner - center));
+                }
+                return res;
+        }
+
+        void build(const std::vector<Point>& points, unsigned num_threads)
+        {
+                const std::size_t n = points.size();
+                if(n == 0){
+                        return;
+                }
+                const unsigned threads = static_cast<unsigned>(std::min<std::size_t>(
+                        thread_count(num_threads), n));
+                std::vector<Hexagon> hexes(n);
+                std::vector<Hexagon> mins(threads, nearest_hex(points[0]/cell_size_));
+                std::vector<Hexagon> maxs(mins);
+                parallel_blocks(n, threads,
+                        [&](std::size_t begin, std::size_t end, unsigned t)
+                        {
+                                for(std::size_t i = begin; i < end; i++){
+                                        const Hexagon hex =
+                                                nearest_hex(points[i]/cell_size_);
+                                        hexes[i] = hex;
+                                        mins[t].a = std::min(mins[t].a, hex.a);
+                                        mins[t].b = std::min(mins[t].b, hex.b);
+                                        maxs[t].a = std::max(maxs[t].a, hex.a);
+                                        maxs[t].b = std::max(maxs[t].b, hex.b);
+                                }
+                        });
+                min_ = mins[0];
+                max_ = maxs[0];
+                for(unsigned t = 1; t < threads; t++){
+                        min_.a = std::min(min_.a, mins[t].a);
+                        min_.b = std::min(min_.b, mins[t].b);
+                        max_.a = std::max(max_.a, maxs[t].a);
+                        max_.b = std::max(max_.b, maxs[t].b);
+                }
+                width_ = max_.a - min_.a + 1;
+                const std::size_t num_cells =
+                        static_cast<std::size_t>(width_)*(max_.b - min_.b + 1);
+
+                // Every thread sorts the (cell, point) pairs of its block, so
+                // it only keeps cursors for the cells it occupies, and one
+                // shared histogram covers the whole bounding parallelogram.
+                // Within a bucket, points stay in the order they were given.
+                std::vector<std::pair<std::size_t, std::size_t>> entries(n);
+                std::vector<std::size_t> begins(threads), ends(threads);
+                parallel_blocks(n, threads,
+                        [&](std::size_t begin, std::size_t end, unsigned t)
+                        {
+                                begins[t] = begin;
+                                ends[t] = end;
+                                for(std::size_t i = begin; i < end; i++){
+                                        entries[i] = {cell_index(hexes[i]), i};
+                                }
+                                std::sort(entries.begin() + begin,
+                                          entries.begin() + end);
+                        });
+                // Count pass: cursors[t][run] is the number of points of
+                // earlier threads in the cell of the run-th run of thread t.
+                offsets_.assign(num_cells + 1, 0);
+                std::vector<std::vector<std::size_t>> cursors(threads);
+                for(unsigned t = 0; t < threads; t++){
+                        for(std::size_t i = begins[t]; i < ends[t];){
+                                const std::size_t cell = entries[i].first;
+                                std::size_t j = i;
+                                while(j < ends[t] && entries[j].first == cell){
+                                        j++;
+                                }
+                                cursors[t].push_back(offsets_[cell]);
+                                offsets_[cell] += j - i;
+                                i = j;
+                        }
+                }
+                std::size_t total = 0;
+                for(std::size_t cell = 0; cell < num_cells; cell++){
+                        const std::size_t count = offsets_[cell];
+                        offsets_[cell] = total;
+                        total += count;
+                }
+                offsets_[num_cells] = total;
+
+                // Scatter pass
+                points_.resize(n);
+                ids_.resize(n);
+                parallel_blocks(n, threads,
+                        [&](std::size_t begin, std::size_t end, unsigned t)
+                        {
+                                std::size_t run = 0;
+                                for(std::size_t i = begin; i < end;){
+                                        const std::size_t cell = entries[i].first;
+                                        std::size_t pos = offsets_[cell] +
+                                                          cursors[t][run++];
+                                        for(; i < end && entries[i].first == cell;
+                                            i++, pos++){
+                                                points_[pos] = points[entries[i].second];
+                                                ids_[pos] = entries[i].second;
+                                        }
+                                }
+                        });
+        }
+};
+
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_POINT_INDEX_H
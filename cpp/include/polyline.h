@@ -0,0 +1,39 @@
+#ifndef HEXAGON_POLYLINE_H
+#define HEXAGON_POLYLINE_H
+
+#include <vector>
+
+#include <point.h>
+#include <edge.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * A sequence of connected points. If closed is true the last point is
+ * connected back to the first one (the first point is not repeated).
+ ******************************************************************************/
+struct Polyline{
+        std::vector<Point> points;
+        bool closed = false;
+
+        /*!*********************************************************************
+         * Return the Edges connecting consecutive points, including the edge
+         * from the last point back to the first if the polyline is closed.
+         **********************************************************************/
+        std::vector<Edge> edges() const
+        {
+                std::vector<Edge> res;
+                if(points.size() < 2){
+                        return res;
+                }
+                res.reserve(points.size());
+                for(std::size_t i = 0; i + 1 < points.size(); i++){
+                        res.push_back(Edge{points[i], points[i + 1]});
+                }
+                if(closed){
+                        res.push_back(Edge{points.back(), points.front()});
+                }
+                return res;
+        }
+};
+}
+#endif //HEXAGON_POLYLINE_H
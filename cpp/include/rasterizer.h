@@ -0,0 +1,239 @@
+#ifndef HEXAGON_RASTERIZER_H
+#define HEXAGON_RASTERIZER_H
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include <point.h>
+#include <hexagon.h>
+#include <hex_field.h>
+#include <parallel.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Rasterizer Rasterizer
+ * Rendering of per-hexagon values to pixel images. Instead of converting
+ * every pixel with nearest_hex(), each scanline is converted once, at its
+ * first pixel, and then walked from left to right. The part of a hexagon on
+ * a horizontal line at height dy above its center extends half_width(dy)
+ * to either side of the center (from the corners() geometry), so the pixel
+ * where the next hexagon starts is known without searching. The next
+ * hexagon is the right neighbour in the middle band of the hexagon, and the
+ * upper or lower right neighbour above or below it.
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * A 4 byte RGBA color, with the layout of a packed 32 bit RGBA pixel.
+ ******************************************************************************/
+struct RGBA{
+        std::uint8_t r = 0, g = 0, b = 0, a = 0;
+};
+
+inline bool operator==(const RGBA& x, const RGBA& y)
+{
+        return x.r == y.r && x.g == y.g && x.b == y.b && x.a == y.a;
+}
+
+inline bool operator!=(const RGBA& x, const RGBA& y)
+{
+        return !(x == y);
+}
+
+/*!*****************************************************************************
+ * Placement of the pixel grid in the plane. Pixel (i, j) is centered at
+ * origin + (i pixel_width, j pixel_height). pixel_width must be positive,
+ * pixel_height may be negative (for images stored top row first with y
+ * pointing up).
+ ******************************************************************************/
+struct RasterView{
+        Point origin;
+        double pixel_width = 1, pixel_height = 1;
+};
+
+namespace detail{
+/*!*****************************************************************************
+ * Half the width of a hexagon along a horizontal line dy above its center
+ * (negative outside the hexagon).
+ ******************************************************************************/
+inline double half_width(double dy)
+{
+        const double abs_dy = std::abs(dy);
+        return abs_dy <= 0.5/std::sqrt(3.) ? 0.5 : 1 - std::sqrt(3.)*abs_dy;
+}
+
+/*!*****************************************************************************
+ * The hexagon entered when leaving hex to the right along a line dy above
+ * its center.
+ ******************************************************************************/
+inline Hexagon right_of(Hexagon hex, double dy)
+{
+        const double band = 0.5/std::sqrt(3.);
+        if(dy > band){
+                return hex + Hexagon{1, 1};
+        }
+        if(dy < -band){
+                return hex + Hexagon{0, -1};
+        }
+        return hex + Hexagon{1, 0};
+}
+
+template<class T>
+typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+blend(T x, T y, double t)
+{
+        const double res = (1 - t)*static_cast<double>(x) +
+                           t*static_cast<double>(y);
+        return static_cast<T>(std::is_integral<T>::value ?
+                              std::floor(res + 0.5) : res);
+}
+
+inline RGBA blend(RGBA x, RGBA y, double t)
+{
+        return {blend(x.r, y.r, t), blend(x.g, y.g, t), blend(x.b, y.b, t),
+                blend(x.a, y.a, t)};
+}
+
+/*!*****************************************************************************
+ * Walks the hexagons along one scanline, from left to right.
+ ******************************************************************************/
+class ScanlineWalker{
+public:
+        ScanlineWalker(Point start)
+         : y_(start.y)
+        {
+                enter(nearest_hex(start));
+        }
+
+        /*!*********************************************************************
+         * Move to the hexagon containing the point at x on the scanline (x
+         * must not decrease between calls).
+         **********************************************************************/
+        void advance(double x)
+        {
+                while(x > right_){
+                        enter(right_of(hex_, dy_));
+                }
+        }
+
+        Hexagon hex() const
+        {
+                return hex_;
+        }
+
+        Hexagon next() const
+        {
+                return right_of(hex_, dy_);
+        }
+
+        /*!*********************************************************************
+         * x where the scanline leaves hex().
+         **********************************************************************/
+        double right() const
+        {
+                return right_;
+        }
+
+private:
+        double y_, dy_ = 0, right_ = 0;
+        Hexagon hex_;
+
+        void enter(Hexagon hex)
+        {
+                const Point center = hex.to_point();
+                hex_ = hex;
+                dy_ = y_ - center.y;
+                right_ = center.x + half_width(dy_);
+        }
+};
+
+/*!*****************************************************************************
+ * Render the width pixels of one row, centered at y. Each span of pixels in
+ * the same hexagon is filled in one go.
+ ******************************************************************************/
+template<class T, class Color>
+void rasterize_row(const Color& color, const RasterView& view, double y,
+                   T* pixels, int width, bool antialias)
+{
+        const double pw = view.pixel_width;
+        // Antialiased pixels are looked up by their left edge.
+        const double x0 = view.origin.x - (antialias ? pw/2 : 0);
+        const auto x = [x0, pw](int i){ return x0 + i*pw; };
+        ScanlineWalker walker(Point{x0, y});
+        for(int i = 0; i < width;){
+                walker.advance(x(i));
+                const double right = walker.right();
+                // First pixel after the span, the estimate is corrected so
+                // that it agrees exactly with ScanlineWalker::advance.
+                int end = static_cast<int>(std::min<double>(
+                        width, std::floor((right - x0)/pw) + 1));
+                end = std::max(end, i + 1);
+                while(end < width && x(end) <= right){
+                        end++;
+                }
+                while(end > i + 1 && x(end - 1) > right){
+                        end--;
+                }
+                const T value = color(walker.hex());
+                std::fill(pixels + i, pixels + end, value);
+                if(antialias && x(end - 1) + pw > right){
+                        const double covered = (right - x(end - 1))/pw;
+                        pixels[end - 1] = blend(
+                                value, static_cast<T>(color(walker.next())),
+                                1 - covered);
+                }
+                i = end;
+        }
+}
+}
+
+/*!*****************************************************************************
+ * Render color(hex) to the width x height image out, pixel (i, j) stored at
+ * out[i + j*stride]. color is called once per span of pixels in the same
+ * hexagon (and once more per edge when antialiasing), nearest_hex() once
+ * per row. Rows are split into bands rendered in parallel on num_threads
+ * threads (0 means one per hardware thread).
+ * With antialias set, pixels containing the edge between two hexagons
+ * are blended with the fraction of the pixel width covered by each (per
+ * channel for RGBA, linearly for arithmetic types).
+ ******************************************************************************/
+template<class T, class Color>
+void rasterize(const Color& color, const RasterView& view, T* out, int width,
+               int height, std::size_t stride, bool antialias = false,
+               unsigned num_threads = 0)
+{
+        HEX_TRACE_SCOPE("rasterize");
+        if(width <= 0 || height <= 0){
+                return;
+        }
+        parallel_blocks(static_cast<std::size_t>(height), num_threads,
+                [&](std::size_t begin, std::size_t end, unsigned)
+                {
+                        for(std::size_t row = begin; row < end; row++){
+                                detail::rasterize_row(color, view,
+                                        view.origin.y + row*view.pixel_height,
+                                        out + row*stride, width, antialias);
+                        }
+                });
+}
+
+/*!*****************************************************************************
+ * Render the values of field, pixels outside it get fallback.
+ ******************************************************************************/
+template<class T>
+void rasterize(const HexField<T>& field, const T& fallback,
+               const RasterView& view, T* out, int width, int height,
+               std::size_t stride, bool antialias = false,
+               unsigned num_threads = 0)
+{
+        rasterize([&field, &fallback](Hexagon hex)
+                  {
+                          return field.get(hex, fallback);
+                  }, view, out, width, height, stride, antialias, num_threads);
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_RASTERIZER_H
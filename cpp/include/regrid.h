@@ -0,0 +1,318 @@
+#ifndef HEXAGON_REGRID_H
+#define HEXAGON_REGRID_H
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <point.h>
+#include <hexagon.h>
+#include <hex_field.h>
+#include <parallel.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Regrid Regrid
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Placement of a hexagonal lattice in the plane: the lattice of
+ * Hexagon::to_point() scaled by scale (the distance between neighbouring
+ * centers), rotated rotation radians counter-clockwise and shifted so that
+ * Hexagon{0, 0} sits at origin.
+ ******************************************************************************/
+struct HexLayout{
+        double scale = 1;
+        double rotation = 0;
+        Point origin;
+
+        Point to_point(Hexagon hex) const
+        {
+                return origin + transform(hex.to_point());
+        }
+
+        Hexagon nearest(Point p) const
+        {
+                using std::cos; using std::sin;
+                const Point d = (p - origin)/scale;
+                const double c = cos(rotation), s = sin(rotation);
+                return nearest_hex(Point{c*d.x + s*d.y, -s*d.x + c*d.y});
+        }
+
+        /*!*********************************************************************
+         * Return the corners of hex, counter-clockwise.
+         **********************************************************************/
+        std::array<Point, 6> corners(Hexagon hex) const
+        {
+                std::array<Point, 6> res = hex.corners();
+                for(auto& corner : res){
+                        corner = origin + transform(corner);
+                }
+                return res;
+        }
+
+        /*!*********************************************************************
+         * Distance from the center of a hexagon to its corners.
+         **********************************************************************/
+        double circumradius() const
+        {
+                return scale/std::sqrt(3.);
+        }
+
+private:
+        Point transform(Point p) const
+        {
+                using std::cos; using std::sin;
+                const double c = cos(rotation), s = sin(rotation);
+                return scale*Point{c*p.x - s*p.y, s*p.x + c*p.y};
+        }
+};
+
+/*!*****************************************************************************
+ * A parallelogram of hexagons (the same shape as a HexField) placed in the
+ * plane by a HexLayout.
+ ******************************************************************************/
+struct LayoutRegion{
+        HexLayout layout;
+        Hexagon origin;
+        int width = 0, height = 0;
+
+        bool contains(Hexagon hex) const
+        {
+                return hex.a >= origin.a && hex.a < origin.a + width &&
+                       hex.b >= origin.b && hex.b < origin.b + height;
+        }
+
+        std::size_t size() const
+        {
+                return static_cast<std::size_t>(width)*height;
+        }
+
+        std::size_t index(Hexagon hex) const
+        {
+                return static_cast<std::size_t>(hex.a - origin.a) +
+                       static_cast<std::size_t>(width)*(hex.b - origin.b);
+        }
+
+        Hexagon hex(std::size_t i) const
+        {
+                return origin + Hexagon{static_cast<int>(i % width),
+                                        static_cast<int>(i / width)};
+        }
+};
+
+enum class RegridMethod{
+        /*!*********************************************************************
+         * Every target cell gets the area weighted mean of the source cells
+         * it overlaps. Preserves integrals where the regions overlap fully.
+         **********************************************************************/
+        conservative,
+        /*!*********************************************************************
+         * Every target cell gets the value of the source cell containing its
+         * center.
+         **********************************************************************/
+        nearest
+};
+
+namespace detail{
+inline double polygon_area(const std::vector<Point>& polygon)
+{
+        double res = 0;
+        for(std::size_t i = 0; i < polygon.size(); i++){
+                const Point& p = polygon[i];
+                const Point& q = polygon[(i + 1) % polygon.size()];
+                res += p.x*q.y - q.x*p.y;
+        }
+        return res/2;
+}
+
+/*!*****************************************************************************
+ * Return the area of the intersection of two convex counter-clockwise
+ * hexagons (Sutherland-Hodgman clipping).
+ ******************************************************************************/
+inline double intersection_area(const std::array<Point, 6>& subject,
+                                const std::array<Point, 6>& clip)
+{
+        std::vector<Point> polygon(subject.begin(), subject.end()), input;
+        for(std::size_t i = 0; i < clip.size() && !polygon.empty(); i++){
+                const Point a = clip[i], b = clip[(i + 1) % clip.size()];
+                const auto side = [a, b](Point p)
+                                  {
+                                          return (b.x - a.x)*(p.y - a.y) -
+                                                 (b.y - a.y)*(p.x - a.x);
+                                  };
+                input.swap(polygon);
+                polygon.clear();
+                for(std::size_t j = 0; j < input.size(); j++){
+                        const Point p = input[j];
+                        const Point q = input[(j + 1) % input.size()];
+                        const double sp = side(p), sq = side(q);
+                        if(sp >= 0){
+                                polygon.push_back(p);
+                        }
+                        if((sp >= 0) != (sq >= 0)){
+                                polygon.push_back(p + (q - p)*(sp/(sp - sq)));
+                        }
+                }
+        }
+        return polygon.size() < 3 ? 0. : polygon_area(polygon);
+}
+}
+
+/*!*****************************************************************************
+ * Resampling of fields from one hexagonal grid to another (different scale,
+ * rotation and offset). The sparse weight matrix is computed once, at
+ * construction, in compressed sparse row form (one row per target cell), and
+ * can then be applied to any number of fields.
+ ******************************************************************************/
+class Regridder{
+public:
+        /*!*********************************************************************
+         * Compute the weights moving fields on src to dst, using num_threads
+         * threads (0 means one per hardware thread).
+         **********************************************************************/
+        Regridder(const LayoutRegion& src, const LayoutRegion& dst,
+                  RegridMethod method = RegridMethod::conservative,
+                  unsigned num_threads = 0)
+         : src_(src), dst_(dst)
+        {
+                std::vector<std::vector<std::pair<std::size_t, double>>>
+                        rows(dst.size());
+                parallel_for(dst.size(), num_threads,
+                             [&](std::size_t row)
+                             {
+                                     rows[row] = method == RegridMethod::nearest ?
+                                             nearest_row(row) :
+                                             conservative_row(row);
+                             });
+                row_offsets_.reserve(rows.size() + 1);
+                row_offsets_.push_back(0);
+                for(const auto& row : rows){
+                        for(const auto& entry : row){
+                                columns_.push_back(entry.first);
+                                weights_.push_back(entry.second);
+                        }
+                        row_offsets_.push_back(columns_.size());
+                }
+        }
+
+        /*!*********************************************************************
+         * Return the field on the target grid computed from values on the
+         * source grid (a sparse matrix-vector product, parallel over target
+         * cells). Target cells not overlapping the source region get
+         * fallback.
+         **********************************************************************/
+        template<class T>
+        HexField<double> apply(const HexField<T>& values,
+                               double fallback =
+                                       std::numeric_limits<double>::quiet_NaN(),
+                               unsigned num_threads = 0) const
+        {
+                if(values.origin() != src_.origin ||
+                   values.width() != src_.width ||
+                   values.height() != src_.height){
+                        throw std::invalid_argument(
+                                "Regridder::apply: field does not match the "
+                                "source region");
+                }
+                HexField<double> res(dst_.origin, dst_.width, dst_.height);
+                const auto& in = values.values();
+                auto& out = res.values();
+                parallel_for(dst_.size(), num_threads,
+                             [&](std::size_t row)
+                             {
+                                     const std::size_t begin = row_offsets_[row];
+                                     const std::size_t end = row_offsets_[row + 1];
+                                     double sum = 0;
+                                     for(std::size_t k = begin; k < end; k++){
+                                             sum += weights_[k]*
+                                                    static_cast<double>(in[columns_[k]]);
+                                     }
+                                     out[row] = begin == end ? fallback : sum;
+                             });
+                return res;
+        }
+
+        /*!*********************************************************************
+         * The weight matrix in CSR form: the entries of target cell i
+         * (HexField storage order) are columns()[k], weights()[k] for k in
+         * [row_offsets()[i], row_offsets()[i + 1]). Columns are source cell
+         * storage indices.
+         **********************************************************************/
+        const std::vector<std::size_t>& row_offsets() const
+        {
+                return row_offsets_;
+        }
+
+        const std::vector<std::size_t>& columns() const
+        {
+                return columns_;
+        }
+
+        const std::vector<double>& weights() const
+        {
+                return weights_;
+        }
+
+private:
+        LayoutRegion src_, dst_;
+        std::vector<std::size_t> row_offsets_, columns_;
+        std::vector<double> weights_;
+
+        std::vector<std::pair<std::size_t, double>>
+        nearest_row(std::size_t row) const
+        {
+                const Hexagon hex = src_.layout.nearest(
+                        dst_.layout.to_point(dst_.hex(row)));
+                if(!src_.contains(hex)){
+                        return {};
+                }
+                return {{src_.index(hex), 1.}};
+        }
+
+        /*!*********************************************************************
+         * Overlap areas of the target cell with all source cells, normalized
+         * by the total overlap with the source region.
+         **********************************************************************/
+        std::vector<std::pair<std::size_t, double>>
+        conservative_row(std::size_t row) const
+        {
+                std::vector<std::pair<std::size_t, double>> res;
+                const Hexagon target = dst_.hex(row);
+                const Point center = dst_.layout.to_point(target);
+                const auto target_corners = dst_.layout.corners(target);
+                // Source centers further away than this can not overlap.
+                const double reach = dst_.layout.circumradius() +
+                                     2*src_.layout.circumradius();
+                const int radius = static_cast<int>(std::ceil(
+                        reach/(src_.layout.scale*std::sqrt(3.)/2)));
+                const double min_area = 1e-12*dst_.layout.scale*dst_.layout.scale;
+                double total = 0;
+                for(const auto& hex : spiral(src_.layout.nearest(center),
+                                             radius)){
+                        if(!src_.contains(hex)){
+                                continue;
+                        }
+                        const double area = detail::intersection_area(
+                                src_.layout.corners(hex), target_corners);
+                        if(area > min_area){
+                                res.push_back({src_.index(hex), area});
+                                total += area;
+                        }
+                }
+                std::sort(res.begin(), res.end());
+                for(auto& entry : res){
+                        entry.second /= total;
+                }
+                return res;
+        }
+};
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+#endif //HEXAGON_REGRID_H
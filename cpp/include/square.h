@@ -0,0 +1,257 @@
+#ifndef HEXAGON_SQUARE_H
+#define HEXAGON_SQUARE_H
+
+#include <cmath>
+#include <iostream>
+#include <array>
+#include <algorithm>
+#include <functional>
+
+#include <point.h>
+#include <edge.h>
+
+namespace Hex{
+/*!*****************************************************************************
+ * \defgroup Square Square
+ * @{
+ ******************************************************************************/
+/*!*****************************************************************************
+ * Basic structure for the square, using the ordinary orthonormal lattice
+ * vectors \f$ \hat{a} = \hat{x}\f$ and \f$ \hat{b} = \hat{y}\f$. The square
+ * center is given as \f$(a, b)\f$ and the square has unit side length, so
+ * that neighbouring square centers are separated by the same distance as
+ * neighbouring Hexagon centers.
+*******************************************************************************/
+struct Square{
+        int a = 0, b = 0;
+
+        /*!*********************************************************************
+         * Return the Point corresponding to the center of the Square.
+         **********************************************************************/
+        Point to_point() const
+        {
+                return {static_cast<double>(this->a),
+                        static_cast<double>(this->b)};
+        }
+
+        /*!*********************************************************************
+         * Return a std::array<Point, 4> containing the 4 corners of the
+         * Square. Starting with the corner \f$ \frac{\pi}{4} \f$ radians above
+         * the a-axis and going counter-clockwise (positive direction).
+         **********************************************************************/
+        std::array<Point, 4> corners() const
+        {
+                const Point center = this->to_point();
+                return {center + Point{ 0.5,  0.5},
+                        center + Point{-0.5,  0.5},
+                        center + Point{-0.5, -0.5},
+                        center + Point{ 0.5, -0.5}};
+        }
+
+        /*!*********************************************************************
+         * Return a std::array<Edge, 4> containing the 4 edges of the
+         * Square. Starting with the edge [corners[0], corners[1]], and going
+         * counter-clockwise (positive direction), ending with the edge
+         * connecting the last corner to the first.
+         **********************************************************************/
+        std::array<Edge, 4> edges() const
+        {
+                const std::array<Point, 4> corners = this->corners();
+                return {Edge{corners[0], corners[1]},
+                        Edge{corners[1], corners[2]},
+                        Edge{corners[2], corners[3]},
+                        Edge{corners[3], corners[0]}};
+        }
+
+        /*!*********************************************************************
+         * Component-wise addition assignment of the square coordinates.
+         **********************************************************************/
+        Square& operator+=(Square other)
+        {
+                a += other.a;
+                b += other.b;
+                return *this;
+        }
+
+        /*!*********************************************************************
+         * Component-wise subtraction assignment of the square coordinates.
+         **********************************************************************/
+        Square& operator-=(Square other)
+        {
+                a -= other.a;
+                b -= other.b;
+                return *this;
+        }
+
+        /*!*********************************************************************
+         * Component-wise scaling  assignment of the square coordinates.
+         **********************************************************************/
+        Square& operator*=(int s)
+        {
+                a *= s;
+                b *= s;
+                return *this;
+        }
+
+        /*!*********************************************************************
+         * Component-wise scaling  assignment of the square coordinates.
+         **********************************************************************/
+        Square& operator/=(int s)
+        {
+                a /= s;
+                b /= s;
+                return *this;
+        }
+
+        /*!*********************************************************************
+         * Return the string "Square(a_, b_)" with a_ and b_ replaced by the a
+         * and b coordinates respectively.
+         **********************************************************************/
+        std::string to_string() const
+        {
+                using std::to_string;
+                return "Square(" + to_string(a) + ", " + to_string(b) + ")";
+        }
+};
+
+inline bool operator==(Square a, Square b)
+{
+        return (a.a == b.a && a.b == b.b);
+}
+inline bool operator!=(Square a, Square b)
+{
+        return !(a == b);
+}
+
+inline Square operator-(Square a)
+{
+        return {-a.a, -a.b};
+}
+inline Square operator+(Square a, Square b)
+{
+        return a += b;
+}
+
+inline Square operator-(Square a, Square b)
+{
+        return a -= b;
+}
+
+inline Square operator*(Square a, int s)
+{
+        return a *= s;
+}
+
+inline Square operator*(int s, Square a)
+{
+        return a*s;
+}
+
+inline Square operator/(Square a, int s)
+{
+        return a /= s;
+}
+
+/*!*****************************************************************************
+ * Rotate the target Square \f$ \frac{\pi}{2} \f$ radians counter-clockwise
+ * (positive direction).
+ ******************************************************************************/
+inline Square rotate(Square a)
+{
+        return {-a.b, a.a};
+}
+
+/*!*****************************************************************************
+ * Rotate the target Square \f$ \frac{\pi}{2} \f$ radians clockwise
+ * (negative direction).
+ ******************************************************************************/
+inline Square rotate_clockwise(Square a)
+{
+        return {a.b, -a.a};
+}
+
+/*!*****************************************************************************
+ * Calculate the Manhattan distance (number of steps along a and b) to reach
+ * the Square sq, \f$ |a| + |b| \f$. This is the step distance on a
+ * 4-connected square grid.
+ ******************************************************************************/
+inline int manhattan_distance(Square sq)
+{
+        using std::abs;
+        return abs(sq.a) + abs(sq.b);
+}
+
+/*!*****************************************************************************
+ * Calculate the Chebyshev distance to reach the Square sq,
+ * \f$ \max(|a|, |b|) \f$. This is the step distance on an 8-connected square
+ * grid (diagonal steps allowed).
+ ******************************************************************************/
+inline int chebyshev_distance(Square sq)
+{
+        using std::abs;
+        return std::max(abs(sq.a), abs(sq.b));
+}
+
+/*!*****************************************************************************
+ * Calculate the Euclidean distance of the square sq, \f$ \sqrt{a^2 + b^2}\f$.
+ ******************************************************************************/
+inline double euclidean_distance(Square sq)
+{
+        using std::sqrt;
+        return sqrt(sq.a*sq.a + sq.b*sq.b);
+}
+
+/*!*****************************************************************************
+ * The 4 edge-sharing neighbours of a Square, counter-clockwise starting along
+ * the a-axis.
+ ******************************************************************************/
+static const std::array<Square, 4> square_neighbor_directions_4 {
+        Square{1, 0}, Square{0, 1}, Square{-1, 0}, Square{0, -1}
+};
+
+/*!*****************************************************************************
+ * The 8 edge- or corner-sharing neighbours of a Square, counter-clockwise
+ * starting along the a-axis.
+ ******************************************************************************/
+static const std::array<Square, 8> square_neighbor_directions_8 {
+        Square{1, 0}, Square{1, 1}, Square{0, 1}, Square{-1, 1},
+        Square{-1, 0}, Square{-1, -1}, Square{0, -1}, Square{1, -1}
+};
+
+/*!*****************************************************************************
+ * Find the Square center closest to the cartesian point (x, y).
+ ******************************************************************************/
+inline Square nearest_square(Point p)
+{
+        using std::round;
+        return Square{static_cast<int>(round(p.x)),
+                      static_cast<int>(round(p.y))};
+}
+
+inline std::string to_string(Square a)
+{
+        return a.to_string();
+}
+
+inline std::ostream& operator<<(std::ostream& os, Square a)
+{
+        return os << a.to_string();
+}
+/*!*****************************************************************************
+* @}
+*******************************************************************************/
+}
+
+namespace std{
+template<>
+struct hash<Hex::Square>{
+        size_t operator()(Hex::Square sq) const noexcept
+        {
+                return hash<unsigned long long>()(
+                        (static_cast<unsigned long long>(
+                                static_cast<unsigned int>(sq.a)) << 32) |
+                         static_cast<unsigned int>(sq.b));
+        }
+};
+}
+#endif //HEXAGON_SQUARE_H
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <concurrent_hex_map.h>
+
+#include <thread>
+#include <climits>
+
+using namespace Hex;
+
+TEST(ConcurrentHexMap, InsertAndLoad)
+{
+        ConcurrentHexMap<int> map(64);
+        ASSERT_EQ(map.load(Hexagon{1, 2}), 0);
+        ASSERT_EQ(map.find(Hexagon{1, 2}), nullptr);
+        map.store(Hexagon{1, 2}, 7);
+        map.store(Hexagon{-1, -2}, 3);
+        ASSERT_EQ(map.load(Hexagon{1, 2}), 7);
+        ASSERT_EQ(map.load(Hexagon{-1, -2}), 3);
+        ASSERT_EQ(map.size(), 2);
+}
+
+TEST(ConcurrentHexMap, CompareExchange)
+{
+        ConcurrentHexMap<int> map(16);
+        int expected = 0;
+        ASSERT_TRUE(map.compare_exchange(Hexagon{0, 0}, expected, 4));
+        expected = 0;
+        ASSERT_FALSE(map.compare_exchange(Hexagon{0, 0}, expected, 5));
+        ASSERT_EQ(expected, 4);
+}
+
+TEST(ConcurrentHexMap, Full)
+{
+        ConcurrentHexMap<int> map(4);
+        for(int i = 0; i < 4; i++){
+                map.store(Hexagon{i, 0}, i);
+        }
+        ASSERT_THROW(map.store(Hexagon{4, 0}, 4), std::length_error);
+}
+
+TEST(ConcurrentHexMap, ReservedKey)
+{
+        ConcurrentHexMap<int> map(16);
+        const Hexagon reserved{INT_MIN, INT_MIN};
+        ASSERT_THROW(map.store(reserved, 1), std::invalid_argument);
+        ASSERT_THROW(map.fetch_add(reserved, 1), std::invalid_argument);
+        ASSERT_EQ(map.find(reserved), nullptr);
+        ASSERT_EQ(map.load(reserved), 0);
+        ASSERT_EQ(map.size(), 0);
+        // Only the pair is reserved.
+        map.store(Hexagon{INT_MIN, 0}, 2);
+        ASSERT_EQ(map.load(Hexagon{INT_MIN, 0}), 2);
+}
+
+/*******************************************************************************
+ * Many threads add to overlapping regions, under increasing contention. Every
+ * thread adds 1 to each hexagon in the same spiral, so every cell should end
+ * up holding the number of threads.
+ ******************************************************************************/
+TEST(ConcurrentHexMap, ContendedFetchAdd)
+{
+        const auto cells = spiral(Hexagon{0, 0}, 8);
+        for(int num_threads : {1, 2, 4, 8, 16, 32, 64}){
+                ConcurrentHexMap<double> map(4*cells.size());
+                std::vector<std::thread> threads;
+                for(int t = 0; t < num_threads; t++){
+                        threads.emplace_back([&map, &cells, t]()
+                        {
+                                // Start at different offsets to mix up the
+                                // insertion order.
+                                for(std::size_t i = 0; i < cells.size(); i++){
+                                        map.fetch_add(cells[(i + 7*t) % cells.size()], 1.);
+                                }
+                        });
+                }
+                for(auto& thread : threads){
+                        thread.join();
+                }
+                ASSERT_EQ(map.size(), cells.size());
+                map.for_each([num_threads](Hexagon, double value)
+                             {
+                                     ASSERT_EQ(value, num_threads);
+                             });
+        }
+}
+
+TEST(ConcurrentHexMap, CompoundUpdateUnderLocks)
+{
+        // Move "units" back and forth between two hexagons in different
+        // regions, the total must be conserved.
+        ConcurrentHexMap<int> map(64);
+        const Hexagon from{0, 0}, to{40, -40};
+        map.store(from, 1000);
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 8; t++){
+                threads.emplace_back([&map, from, to, t]()
+                {
+                        for(int i = 0; i < 1000; i++){
+                                const Hexagon src = (i + t) % 2 ? from : to;
+                                const Hexagon dst = src == from ? to : from;
+                                map.with_locks({src, dst}, [&]()
+                                {
+                                        if(map.load(src) > 0){
+                                                map.store(src, map.load(src) - 1);
+                                                map.store(dst, map.load(dst) + 1);
+                                        }
+                                });
+                        }
+                });
+        }
+        for(auto& thread : threads){
+                thread.join();
+        }
+        ASSERT_EQ(map.load(from) + map.load(to), 1000);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <contour.h>
+
+#include <set>
+#include <stdexcept>
+
+using namespace Hex;
+
+namespace{
+double signed_area(const Polyline& polyline)
+{
+        double res = 0;
+        for(const auto& edge : polyline.edges()){
+                res += edge.start.x*edge.stop.y - edge.stop.x*edge.start.y;
+        }
+        return res/2;
+}
+
+HexField<double> cone(Hexagon center, int radius)
+{
+        HexField<double> res(center - Hexagon{radius, radius}, 2*radius + 1,
+                             2*radius + 1);
+        for(std::size_t i = 0; i < res.size(); i++){
+                const Point d = res.hex(i).to_point() - center.to_point();
+                res.values()[i] = radius - std::sqrt(d.x*d.x + d.y*d.y);
+        }
+        return res;
+}
+}
+
+TEST(Contour, Peak)
+{
+        const Hexagon center{3, -2};
+        const auto field = cone(center, 12);
+        const auto res = contour(field, 7.5);
+        ASSERT_EQ(res.level, 7.5);
+        ASSERT_EQ(res.polylines.size(), 1u);
+        const Polyline& line = res.polylines[0];
+        ASSERT_TRUE(line.closed);
+        // Counter-clockwise around the maximum, close to a circle of radius
+        // 4.5.
+        ASSERT_NEAR(signed_area(line), std::acos(-1.)*4.5*4.5, 1.5);
+        const Point c = center.to_point();
+        std::set<std::pair<double, double>> unique;
+        for(const auto& p : line.points){
+                const Point d = p - c;
+                ASSERT_NEAR(std::sqrt(d.x*d.x + d.y*d.y), 4.5, 0.1);
+                unique.insert({p.x, p.y});
+        }
+        ASSERT_EQ(unique.size(), line.points.size());
+}
+
+TEST(Contour, OpenLinesAtBorder)
+{
+        // Values increasing with x: straight open lines, with x above the level
+        // on the left, i.e. running downwards.
+        HexField<double> field(Hexagon{0, 0}, 20, 10);
+        for(std::size_t i = 0; i < field.size(); i++){
+                field.values()[i] = field.hex(i).to_point().x;
+        }
+        const auto res = contour(field, 6.25);
+        ASSERT_EQ(res.polylines.size(), 1u);
+        const Polyline& line = res.polylines[0];
+        ASSERT_FALSE(line.closed);
+        ASSERT_GT(line.points.front().y, line.points.back().y);
+        for(const auto& p : line.points){
+                ASSERT_NEAR(p.x, 6.25, 1e-12);
+        }
+        for(const auto& edge : line.edges()){
+                ASSERT_LT(edge.stop.y, edge.start.y);
+        }
+}
+
+TEST(Contour, TilesAndThreadsAgree)
+{
+        HexField<float> field(Hexagon{-30, -20}, 70, 45);
+        for(std::size_t i = 0; i < field.size(); i++){
+                const Point p = field.hex(i).to_point();
+                field.values()[i] = static_cast<float>(std::sin(0.3*p.x)*std::cos(0.25*p.y) +
+                                                       0.01*p.x + 0.0123);
+        }
+        const std::vector<double> levels{0.5, -0.25, 0., 0.75, 3.};
+        const auto reference = contours(field, levels, 1, 1000);
+        const auto tiled = contours(field, levels, 4, 7);
+        ASSERT_EQ(reference.size(), levels.size());
+        ASSERT_TRUE(reference.back().polylines.empty());
+        for(std::size_t l = 0; l < levels.size(); l++){
+                ASSERT_EQ(reference[l].level, levels[l]);
+                ASSERT_EQ(tiled[l].level, levels[l]);
+                // Same lines, possibly in a different order or starting point.
+                std::multiset<std::pair<double, double>> a, b;
+                std::size_t closed_a = 0, closed_b = 0;
+                for(const auto& line : reference[l].polylines){
+                        closed_a += line.closed;
+                        for(const auto& p : line.points){
+                                a.insert({p.x, p.y});
+                        }
+                }
+                for(const auto& line : tiled[l].polylines){
+                        closed_b += line.closed;
+                        for(const auto& p : line.points){
+                                b.insert({p.x, p.y});
+                        }
+                }
+                ASSERT_EQ(reference[l].polylines.size(), tiled[l].polylines.size());
+                ASSERT_EQ(closed_a, closed_b);
+                ASSERT_EQ(a, b);
+                // No vertex appears twice.
+                const std::set<std::pair<double, double>> unique(a.begin(), a.end());
+                ASSERT_EQ(unique.size(), a.size());
+        }
+}
+
+TEST(Contour, SkipsNaN)
+{
+        auto field = cone(Hexagon{0, 0}, 6);
+        field[Hexagon{3, 0}] = std::numeric_limits<double>::quiet_NaN();
+        const auto res = contour(field, 3.);
+        ASSERT_EQ(res.polylines.size(), 1u);
+        ASSERT_FALSE(res.polylines[0].closed);
+}
+
+TEST(Contour, LevelThroughCenters)
+{
+        // The level is hit exactly at every center with a = 0, the line
+        // passes through them without repeating points.
+        HexField<int> field(Hexagon{-5, -5}, 11, 11);
+        for(std::size_t i = 0; i < field.size(); i++){
+                field.values()[i] = field.hex(i).a;
+        }
+        const auto res = contour(field, 0.);
+        ASSERT_EQ(res.polylines.size(), 1u);
+        const auto& points = res.polylines[0].points;
+        for(std::size_t i = 1; i < points.size(); i++){
+                ASSERT_NE(points[i], points[i - 1]);
+        }
+}
+
+TEST(Contour, InvalidTileSize)
+{
+        const HexField<double> field(Hexagon{0, 0}, 8, 8, 1.);
+        for(int tile_size : {0, -4}){
+                ASSERT_THROW(contours(field, {0.5}, 2, tile_size),
+                             std::invalid_argument);
+        }
+}
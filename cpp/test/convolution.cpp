@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <convolution.h>
+
+#include <stdexcept>
+
+using namespace Hex;
+
+TEST(Convolution, Kernel)
+{
+        const auto kernel = HexKernel::from_function(2, [](Hexagon offset)
+                            {
+                                    return 1. + manhattan_distance(offset);
+                            });
+        ASSERT_EQ(kernel.weights.size(), 25u);
+        ASSERT_EQ(kernel(Hexagon{0, 0}), 1.);
+        ASSERT_EQ(kernel(Hexagon{1, 1}), 2.);
+        ASSERT_EQ(kernel(Hexagon{-2, 0}), 3.);
+        ASSERT_EQ(kernel(Hexagon{2, -2}), 0.);
+        ASSERT_EQ(kernel(Hexagon{3, 0}), 0.);
+}
+
+TEST(Convolution, DirectImpulse)
+{
+        const auto kernel = HexKernel::from_function(1, [](Hexagon offset)
+                            {
+                                    return offset == Hexagon{0, 0} ? 2. : 1.;
+                            });
+        HexField<int> field(Hexagon{0, 0}, 5, 5);
+        field[Hexagon{2, 2}] = 1;
+        const auto res = convolve(field, kernel, ConvolutionMethod::direct);
+        for(std::size_t i = 0; i < res.size(); i++){
+                const Hexagon hex = res.hex(i);
+                ASSERT_EQ(res.values()[i], kernel(hex - Hexagon{2, 2}));
+        }
+}
+
+TEST(Convolution, FFTMatchesDirect)
+{
+        HexField<double> field(Hexagon{4, -7}, 37, 21);
+        for(std::size_t i = 0; i < field.size(); i++){
+                field.values()[i] = std::sin(0.37*i) + (i % 5 == 0);
+        }
+        // An asymmetric kernel, so that mixing up convolution and correlation
+        // shows.
+        for(int radius : {0, 3, 16}){
+                const auto kernel = HexKernel::from_function(radius,
+                                    [](Hexagon offset)
+                                    {
+                                            return 1./(1 + manhattan_distance(offset)) +
+                                                   0.1*offset.a;
+                                    });
+                const auto direct = convolve(field, kernel, ConvolutionMethod::direct, 2);
+                const auto fast = convolve(field, kernel, ConvolutionMethod::fft, 2);
+                const auto automatic = convolve(field, kernel);
+                ASSERT_EQ(fast.origin(), field.origin());
+                ASSERT_EQ(fast.width(), field.width());
+                ASSERT_EQ(fast.height(), field.height());
+                for(std::size_t i = 0; i < field.size(); i++){
+                        ASSERT_NEAR(direct.values()[i], fast.values()[i], 1e-9);
+                        ASSERT_NEAR(direct.values()[i], automatic.values()[i], 1e-9);
+                }
+        }
+}
+
+TEST(Convolution, InvalidArguments)
+{
+        const HexField<double> field(Hexagon{0, 0}, 6, 5, 1.);
+        const HexKernel negative{-1, {}};
+        ASSERT_THROW(convolve(field, negative, ConvolutionMethod::fft, 4),
+                     std::invalid_argument);
+        ASSERT_THROW(convolve(field, negative, ConvolutionMethod::direct, 4),
+                     std::invalid_argument);
+        // Default constructed or inconsistent kernels have the wrong number
+        // of weights.
+        for(const auto& kernel : {HexKernel{}, HexKernel{2, std::vector<double>(9)}}){
+                ASSERT_THROW(convolve(field, kernel, ConvolutionMethod::fft, 4),
+                             std::invalid_argument);
+                ASSERT_THROW(convolve(field, kernel, ConvolutionMethod::direct, 4),
+                             std::invalid_argument);
+        }
+        // Empty fields give empty results on both paths.
+        const HexField<double> empty(Hexagon{0, 0}, 0, 5);
+        const auto kernel = HexKernel::from_function(2, [](Hexagon){ return 1.; });
+        ASSERT_EQ(convolve(empty, kernel, ConvolutionMethod::fft, 4).size(), 0u);
+        ASSERT_EQ(convolve(empty, kernel, ConvolutionMethod::direct, 4).size(), 0u);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <delta.h>
+#include <algorithm>
+
+using namespace Hex;
+
+namespace{
+template<class T, int ChunkBits>
+std::vector<std::pair<Hexagon, T>> cells(const HexWorld<T, ChunkBits>& world)
+{
+        std::vector<std::pair<Hexagon, T>> res;
+        world.for_each([&res](Hexagon hex, const T& value){ res.push_back({hex, value}); });
+        std::sort(res.begin(), res.end(),
+                  [](const std::pair<Hexagon, T>& x, const std::pair<Hexagon, T>& y)
+                  {
+                          return std::make_pair(x.first.a, x.first.b) <
+                                 std::make_pair(y.first.a, y.first.b);
+                  });
+        return res;
+}
+
+struct Tile{
+        std::uint8_t terrain;
+        float height;
+};
+}
+
+TEST(Delta, SyncsReplica)
+{
+        HexWorld<int, 3> world, replica;
+        for(const auto& hex : spiral(Hexagon{0, 0}, 12)){
+                world[hex] = hex.a - 3*hex.b;
+        }
+        auto delta = encode_delta(world);
+        auto header = apply_delta(replica, delta);
+        ASSERT_EQ(header.base_epoch, 0u);
+        ASSERT_EQ(header.epoch, 1u);
+        ASSERT_FALSE(header.reset);
+        ASSERT_EQ(world.epoch(), 1u);
+        ASSERT_EQ(cells(replica), cells(world));
+
+        world[Hexagon{100, -40}] = 7;
+        world[Hexagon{-3, 2}] = 8;
+        delta = encode_delta(world);
+        header = apply_delta(replica, delta);
+        ASSERT_EQ(header.base_epoch, 1u);
+        ASSERT_EQ(header.epoch, 2u);
+        ASSERT_EQ(cells(replica), cells(world));
+
+        // Nothing changed, only the header and terminator are sent.
+        delta = encode_delta(world);
+        ASSERT_EQ(delta.size(), 4u);
+}
+
+TEST(Delta, SizeScalesWithChanges)
+{
+        HexWorld<std::uint16_t> world;
+        for(const auto& hex : spiral(Hexagon{0, 0}, 60)){
+                world[hex] = 1;
+        }
+        encode_delta(world);
+        for(int a = 10; a < 20; a++){
+                world[Hexagon{a, 5}] = 2;
+        }
+        // A single run: header, length, two offsets and ten values.
+        const auto delta = encode_delta(world);
+        ASSERT_LT(delta.size(), 10*sizeof(std::uint16_t) + 12);
+}
+
+TEST(Delta, ClearAndFull)
+{
+        HexWorld<Tile, 2> world, replica;
+        world[Hexagon{1, 2}] = Tile{3, 1.5f};
+        world[Hexagon{2, 2}] = Tile{4, -2.f};
+        apply_delta(replica, encode_delta(world));
+        world.clear();
+        world[Hexagon{-7, 0}] = Tile{1, 0.25f};
+        const auto header = apply_delta(replica, encode_delta(world));
+        ASSERT_TRUE(header.reset);
+        ASSERT_EQ(replica.size(), 1u);
+        ASSERT_EQ(replica.get(Hexagon{-7, 0}).terrain, 1);
+        ASSERT_EQ(replica.get(Hexagon{-7, 0}).height, 0.25f);
+
+        HexWorld<Tile, 2> late;
+        late[Hexagon{50, 50}] = Tile{9, 9.f};
+        apply_delta(late, encode_full(world));
+        ASSERT_EQ(late.size(), 1u);
+        ASSERT_EQ(late.get(Hexagon{-7, 0}).terrain, 1);
+}
+
+TEST(Delta, MalformedInput)
+{
+        HexWorld<int> world, replica;
+        world[Hexagon{0, 0}] = 1;
+        world[Hexagon{1, 0}] = 2;
+        auto delta = encode_delta(world);
+        const auto truncated = std::vector<std::uint8_t>(delta.begin(), delta.end() - 3);
+        ASSERT_THROW(apply_delta(replica, truncated), std::invalid_argument);
+        delta.push_back(0);
+        ASSERT_THROW(apply_delta(replica, delta), std::invalid_argument);
+}
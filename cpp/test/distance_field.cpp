@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <distance_field.h>
+
+#include <random>
+
+using namespace Hex;
+
+namespace{
+HexField<unsigned char> random_features(int width, int height, double density,
+                                        unsigned seed)
+{
+        std::mt19937 gen(seed);
+        std::bernoulli_distribution dist(density);
+        HexField<unsigned char> res(Hexagon{-3, 5}, width, height);
+        for(auto& value : res.values()){
+                value = dist(gen);
+        }
+        return res;
+}
+}
+
+TEST(DistanceField, SingleFeature)
+{
+        HexField<unsigned char> features(Hexagon{0, 0}, 9, 9);
+        const Hexagon center{4, 4};
+        features[center] = 1;
+        const auto res = distance_transform(features, 1);
+        for(std::size_t i = 0; i < res.size(); i++){
+                ASSERT_EQ(res.values()[i], manhattan_distance(res.hex(i) - center));
+        }
+}
+
+TEST(DistanceField, NoFeatures)
+{
+        HexField<unsigned char> features(Hexagon{0, 0}, 3, 3);
+        const auto res = distance_transform(features, 1);
+        ASSERT_EQ((res[Hexagon{1, 1}]), std::numeric_limits<int>::max());
+        ASSERT_TRUE(std::isinf(euclidean_distance_transform(features).values()[4]));
+}
+
+TEST(DistanceField, ManhattanMatchesBruteForceParallel)
+{
+        // Sizes that are not multiples of the tile size, to exercise the
+        // tile wavefront.
+        const auto features = random_features(150, 130, 0.002, 1);
+        const auto res = distance_transform(features, 4);
+        const auto serial = distance_transform(features, 1);
+        ASSERT_EQ(res.origin(), features.origin());
+        ASSERT_EQ(res.values(), serial.values());
+        for(std::size_t i = 0; i < res.size(); i++){
+                int best = std::numeric_limits<int>::max();
+                for(std::size_t j = 0; j < features.size(); j++){
+                        if(features.values()[j]){
+                                best = std::min(best, manhattan_distance(
+                                        features.hex(i) - features.hex(j)));
+                        }
+                }
+                ASSERT_EQ(res.values()[i], best);
+        }
+}
+
+TEST(DistanceField, EuclideanCloseToBruteForce)
+{
+        const auto features = random_features(70, 90, 0.01, 2);
+        const auto res = euclidean_distance_transform(features, 3);
+        for(std::size_t i = 0; i < res.size(); i++){
+                double best = std::numeric_limits<double>::infinity();
+                for(std::size_t j = 0; j < features.size(); j++){
+                        if(features.values()[j]){
+                                best = std::min(best, euclidean_distance(
+                                        features.hex(i) - features.hex(j)));
+                        }
+                }
+                ASSERT_GE(res.values()[i], best - 1e-12);
+                ASSERT_LE(res.values()[i], best + 1.);
+        }
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <fft.h>
+
+#include <stdexcept>
+
+using namespace Hex;
+
+TEST(FFT, PowerOfTwo)
+{
+        ASSERT_TRUE(is_power_of_two(1));
+        ASSERT_TRUE(is_power_of_two(64));
+        ASSERT_FALSE(is_power_of_two(0));
+        ASSERT_FALSE(is_power_of_two(12));
+        ASSERT_EQ(next_power_of_two(1), 1u);
+        ASSERT_EQ(next_power_of_two(17), 32u);
+        std::vector<std::complex<double>> data(6);
+        ASSERT_THROW(fft(data), std::invalid_argument);
+}
+
+TEST(FFT, MatchesDFT)
+{
+        const std::size_t n = 16;
+        std::vector<std::complex<double>> data(n);
+        for(std::size_t i = 0; i < n; i++){
+                data[i] = {std::sin(0.7*i), std::cos(1.3*i)};
+        }
+        auto transformed = data;
+        fft(transformed);
+        const double pi = std::acos(-1.);
+        for(std::size_t k = 0; k < n; k++){
+                std::complex<double> sum = 0;
+                for(std::size_t j = 0; j < n; j++){
+                        sum += data[j]*std::polar(1., -2*pi*j*k/n);
+                }
+                ASSERT_NEAR(std::abs(transformed[k] - sum), 0, 1e-9);
+        }
+        fft(transformed, true);
+        for(std::size_t i = 0; i < n; i++){
+                ASSERT_NEAR(std::abs(transformed[i] - data[i]), 0, 1e-12);
+        }
+}
+
+TEST(FFT, HexRoundTrip)
+{
+        HexField<std::complex<double>> field(Hexagon{-3, 2}, 8, 4);
+        for(std::size_t i = 0; i < field.size(); i++){
+                field.values()[i] = static_cast<double>(i % 7) - 2.5;
+        }
+        const auto original = field.values();
+        hex_fft(field, false, 3);
+        // The zero frequency term is the sum over the field.
+        std::complex<double> sum = 0;
+        for(const auto& value : original){
+                sum += value;
+        }
+        ASSERT_NEAR(std::abs(field.values()[0] - sum), 0, 1e-9);
+        hex_fft(field, true, 3);
+        for(std::size_t i = 0; i < field.size(); i++){
+                ASSERT_NEAR(std::abs(field.values()[i] - original[i]), 0, 1e-12);
+        }
+}
+
+TEST(FFT, HexInvalidSize)
+{
+        // Rejected before any worker thread starts.
+        HexField<std::complex<double>> not_power(Hexagon{0, 0}, 6, 4);
+        ASSERT_THROW(hex_fft(not_power, false, 4), std::invalid_argument);
+        HexField<std::complex<double>> empty(Hexagon{0, 0}, 0, 4);
+        ASSERT_THROW(hex_fft(empty, false, 4), std::invalid_argument);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <flow_field.h>
+
+#include <random>
+
+using namespace Hex;
+
+namespace{
+const double inf = std::numeric_limits<double>::infinity();
+
+HexField<double> random_costs(std::mt19937& rng, int width, int height)
+{
+        std::uniform_real_distribution<double> cost(1, 4);
+        std::uniform_int_distribution<int> wall(0, 9);
+        HexField<double> res(Hexagon{-5, 3}, width, height);
+        for(auto& value : res.values()){
+                value = wall(rng) == 0 ? inf : cost(rng);
+        }
+        return res;
+}
+
+// Every cell steps to a neighbour with consistent distances.
+void check_consistent(const FlowField& flow)
+{
+        const auto& costs = flow.costs();
+        for(std::size_t i = 0; i < costs.size(); i++){
+                const Hexagon hex = costs.hex(i);
+                const int dir = flow.direction(hex);
+                if(dir == FlowField::goal){
+                        ASSERT_EQ(flow.distance(hex), 0.);
+                }else if(dir == FlowField::none){
+                        ASSERT_EQ(flow.distance(hex), inf);
+                }else{
+                        const Hexagon next = flow.next(hex);
+                        ASSERT_NEAR(flow.distance(hex),
+                                    flow.distance(next) + costs[next], 1e-9);
+                }
+        }
+}
+}
+
+TEST(FlowField, UniformCost)
+{
+        const FlowField flow(HexField<double>(Hexagon{-10, -10}, 21, 21, 1.),
+                             {Hexagon{0, 0}});
+        ASSERT_EQ(flow.direction(Hexagon{0, 0}), FlowField::goal);
+        ASSERT_EQ(flow.direction(Hexagon{100, 0}), FlowField::none);
+        for(const auto& hex : spiral(Hexagon{0, 0}, 10)){
+                ASSERT_EQ(flow.distance(hex), manhattan_distance(hex));
+        }
+        ASSERT_EQ(flow.next(Hexagon{3, 0}), (Hexagon{2, 0}));
+        ASSERT_EQ(flow.direction(Hexagon{0, -4}), 2);
+        check_consistent(flow);
+}
+
+TEST(FlowField, Walls)
+{
+        HexField<double> costs(Hexagon{0, 0}, 10, 10, 1.);
+        for(int b = 0; b < 9; b++){
+                costs[Hexagon{5, b}] = inf;
+        }
+        costs[Hexagon{2, 7}] = inf;
+        const FlowField flow(costs, {Hexagon{9, 0}, Hexagon{40, 40}});
+        ASSERT_EQ(flow.direction(Hexagon{5, 3}), FlowField::none);
+        ASSERT_EQ(flow.direction(Hexagon{2, 7}), FlowField::none);
+        // Agents left of the wall go around it at the top.
+        Hexagon hex{0, 0};
+        for(int steps = 0; flow.direction(hex) != FlowField::goal; steps++){
+                ASSERT_LT(steps, 100);
+                ASSERT_NE(costs[flow.next(hex)], inf);
+                hex = flow.next(hex);
+        }
+        ASSERT_EQ(hex, (Hexagon{9, 0}));
+        check_consistent(flow);
+}
+
+TEST(FlowField, RepairMatchesRebuild)
+{
+        std::mt19937 rng(7);
+        const auto costs = random_costs(rng, 40, 30);
+        const std::vector<Hexagon> goals{Hexagon{0, 10}, Hexagon{20, 25}};
+        FlowField flow(costs, goals);
+        std::uniform_int_distribution<std::size_t> cell(0, costs.size() - 1);
+        std::uniform_real_distribution<double> cost(0.5, 6);
+        for(int round = 0; round < 20; round++){
+                for(int k = 0; k < 4; k++){
+                        const Hexagon hex = costs.hex(cell(rng));
+                        flow.set_cost(hex, k == 0 ? inf : cost(rng));
+                }
+                flow.repair();
+                const FlowField rebuilt(flow.costs(), goals);
+                for(std::size_t i = 0; i < costs.size(); i++){
+                        const Hexagon hex = costs.hex(i);
+                        ASSERT_EQ(flow.distance(hex), rebuilt.distance(hex));
+                }
+                check_consistent(flow);
+        }
+}
+
+TEST(FlowField, RepairIsLocal)
+{
+        FlowField flow(HexField<double>(Hexagon{0, 0}, 100, 100, 1.),
+                       {Hexagon{0, 0}});
+        // Nothing routes through the far corner.
+        flow.set_cost(Hexagon{99, 99}, 5.);
+        ASSERT_EQ(flow.repair(), 0u);
+        flow.set_cost(Hexagon{99, 99}, inf);
+        ASSERT_EQ(flow.repair(), 1u);
+        ASSERT_EQ(flow.direction(Hexagon{99, 99}), FlowField::none);
+        flow.set_cost(Hexagon{99, 99}, 1.);
+        flow.repair();
+        ASSERT_EQ(flow.distance(Hexagon{99, 99}), 99.);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <grid.h>
+
+#include <limits>
+
+using namespace Hex;
+
+TEST(Grid, HexRingMatchesRing)
+{
+        Hexagon h{2, -1};
+        for(int r = 0; r < 4; r++){
+                ASSERT_EQ(ring<HexGrid>(h, r), ring(h, r));
+        }
+}
+
+TEST(Grid, HexSpiralMatchesSpiral)
+{
+        Hexagon h{2, -1};
+        ASSERT_EQ(spiral<HexGrid>(h, 3), spiral(h, 3));
+}
+
+TEST(Grid, Square4Ring)
+{
+        Square s{0, 0};
+        std::vector<Square> answer = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
+        ASSERT_EQ(ring<SquareGrid4>(s, 1), answer);
+        for(const auto& cell : ring<SquareGrid4>(s, 3)){
+                ASSERT_EQ(manhattan_distance(cell), 3);
+        }
+        ASSERT_EQ(ring<SquareGrid4>(s, 3).size(), 12);
+}
+
+TEST(Grid, Square8Ring)
+{
+        Square s{0, 0};
+        std::vector<Square> answer = {{-1, -1}, {0, -1}, {1, -1}, {1, 0},
+                                      {1, 1}, {0, 1}, {-1, 1}, {-1, 0}};
+        ASSERT_EQ(ring<SquareGrid8>(s, 1), answer);
+        ASSERT_EQ(spiral<SquareGrid8>(s, 2).size(), 25);
+}
+
+TEST(Grid, Neighbors)
+{
+        Hexagon h{1, 1};
+        auto hex_neighbors = neighbors<HexGrid>(h);
+        ASSERT_EQ(hex_neighbors[0], (Hexagon{2, 1}));
+        auto square_neighbors = neighbors<SquareGrid8>(Square{0, 0});
+        ASSERT_EQ(square_neighbors.size(), 8);
+}
+
+TEST(Grid, FloodFill)
+{
+        auto inside = [](Hexagon h){ return manhattan_distance(h) <= 2; };
+        ASSERT_EQ(flood_fill<HexGrid>(Hexagon{0, 0}, inside).size(), 19);
+        auto open = [](Square){ return true; };
+        ASSERT_EQ(flood_fill<SquareGrid4>(Square{0, 0}, open, 2).size(), 13);
+}
+
+TEST(Grid, FindPathAroundWall)
+{
+        // Wall along a = 1 with a single gap at b = 3.
+        auto cost = [](Square s)
+                    {
+                            if(s.a == 1 && s.b != 3){
+                                    return std::numeric_limits<double>::infinity();
+                            }
+                            return 1.;
+                    };
+        auto path = find_path<SquareGrid4>(Square{0, 0}, Square{2, 0}, cost, 10);
+        ASSERT_EQ(path.front(), (Square{0, 0}));
+        ASSERT_EQ(path.back(), (Square{2, 0}));
+        ASSERT_EQ(path.size(), 9);
+}
+
+TEST(Grid, FindPathHex)
+{
+        auto cost = [](Hexagon){ return 1.; };
+        auto path = find_path<HexGrid>(Hexagon{0, 0}, Hexagon{3, -2}, cost);
+        ASSERT_EQ(path.size(), manhattan_distance(Hexagon{3, -2}) + 1);
+}
+
+TEST(Grid, FindPathUnreachable)
+{
+        auto cost = [](Hexagon h)
+                    {
+                            return manhattan_distance(h - Hexagon{4, 0}) == 1 ?
+                                    std::numeric_limits<double>::infinity() : 1.;
+                    };
+        ASSERT_TRUE((find_path<HexGrid>(Hexagon{0, 0}, Hexagon{4, 0}, cost, 8)).empty());
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include <hex_field.h>
+
+using namespace Hex;
+
+TEST(HexField, IndexOrdering)
+{
+        HexField<int> field(Hexagon{-2, 3}, 4, 3);
+        ASSERT_EQ(field.size(), 12);
+        ASSERT_EQ(field.index(Hexagon{-2, 3}), 0);
+        ASSERT_EQ(field.index(Hexagon{-1, 3}), 1);
+        ASSERT_EQ(field.index(Hexagon{-2, 4}), 4);
+        for(std::size_t i = 0; i < field.size(); i++){
+                ASSERT_EQ(field.index(field.hex(i)), i);
+        }
+}
+
+TEST(HexField, Contains)
+{
+        HexField<int> field(Hexagon{0, 0}, 2, 2);
+        ASSERT_TRUE(field.contains(Hexagon{1, 1}));
+        ASSERT_FALSE(field.contains(Hexagon{2, 1}));
+        ASSERT_FALSE(field.contains(Hexagon{0, -1}));
+}
+
+TEST(HexField, ReadWrite)
+{
+        HexField<int> field(Hexagon{0, 0}, 3, 3, 7);
+        field[Hexagon{1, 2}] = 3;
+        ASSERT_EQ((field[Hexagon{1, 2}]), 3);
+        ASSERT_EQ(field.get(Hexagon{0, 0}), 7);
+        ASSERT_EQ((field.get(Hexagon{5, 5}, -1)), -1);
+}
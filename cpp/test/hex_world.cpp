@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <hex_world.h>
+
+using namespace Hex;
+
+TEST(HexWorld, EmptyReadsDefault)
+{
+        HexWorld<int> world;
+        ASSERT_EQ(world.get(Hexagon{3, -7}), 0);
+        ASSERT_FALSE(world.contains(Hexagon{3, -7}));
+        ASSERT_EQ(world.chunk_count(), 0);
+}
+
+TEST(HexWorld, WriteAllocatesChunk)
+{
+        HexWorld<int> world;
+        world[Hexagon{3, -7}] = 5;
+        ASSERT_EQ(world.get(Hexagon{3, -7}), 5);
+        ASSERT_TRUE(world.contains(Hexagon{3, -7}));
+        ASSERT_FALSE(world.contains(Hexagon{4, -7}));
+        ASSERT_EQ(world.size(), 1);
+        ASSERT_EQ(world.chunk_count(), 1);
+}
+
+TEST(HexWorld, NegativeCoordinates)
+{
+        HexWorld<int, 2> world;
+        ASSERT_EQ((HexWorld<int, 2>::chunk_of(Hexagon{-1, -4})), (Hexagon{-1, -1}));
+        ASSERT_EQ((HexWorld<int, 2>::chunk_of(Hexagon{-5, 3})), (Hexagon{-2, 0}));
+        world[Hexagon{-1, 0}] = 1;
+        world[Hexagon{0, 0}] = 2;
+        ASSERT_EQ(world.get(Hexagon{-1, 0}), 1);
+        ASSERT_EQ(world.get(Hexagon{0, 0}), 2);
+        ASSERT_EQ(world.chunk_count(), 2);
+}
+
+TEST(HexWorld, ForEachVisitsOccupiedCells)
+{
+        HexWorld<int, 3> world;
+        for(const auto& hex : spiral(Hexagon{0, 0}, 10)){
+                world[hex] = manhattan_distance(hex);
+        }
+        std::size_t count = 0;
+        world.for_each([&](Hexagon hex, int value)
+                       {
+                               ASSERT_EQ(value, manhattan_distance(hex));
+                               count++;
+                       });
+        ASSERT_EQ(count, spiral(Hexagon{0, 0}, 10).size());
+        ASSERT_EQ(world.size(), count);
+}
+
+TEST(HexWorld, NeighborsAcrossChunks)
+{
+        HexWorld<int, 2> world;
+        const Hexagon center{3, 3};
+        for(const auto& hex : ring(center, 1)){
+                world[hex] = hex.a + 10*hex.b;
+        }
+        int visited = 0;
+        world.for_each_neighbor(center, [&](Hexagon hex, const int* value)
+                                {
+                                        ASSERT_NE(value, nullptr);
+                                        ASSERT_EQ(*value, hex.a + 10*hex.b);
+                                        visited++;
+                                });
+        ASSERT_EQ(visited, 6);
+        world.for_each_neighbor(Hexagon{-10, -10}, [](Hexagon, const int* value)
+                                {
+                                        ASSERT_EQ(value, nullptr);
+                                });
+}
+
+TEST(HexWorld, ClearReusesChunks)
+{
+        HexWorld<int, 2> world;
+        world[Hexagon{0, 0}] = 1;
+        world.clear();
+        ASSERT_TRUE(world.empty());
+        ASSERT_EQ(world.chunk_count(), 0);
+        world[Hexagon{100, 100}] = 2;
+        ASSERT_EQ(world.get(Hexagon{100, 100}), 2);
+        ASSERT_EQ(world.get(Hexagon{100 + 1, 100}), 0);
+}
+
+TEST(HexWorld, DirtyTracking)
+{
+        HexWorld<int, 2> world;
+        ASSERT_EQ(world.epoch(), 0u);
+        world[Hexagon{1, 1}] = 1;
+        world.set(Hexagon{-5, 9}, 2);
+        world[Hexagon{1, 1}] = 3;
+        std::vector<Hexagon> dirty;
+        world.for_each_dirty([&](Hexagon hex, int){ dirty.push_back(hex); });
+        ASSERT_EQ(dirty, (std::vector<Hexagon>{{1, 1}, {-5, 9}}));
+
+        ASSERT_EQ(world.snapshot(), 1u);
+        dirty.clear();
+        world.for_each_dirty([&](Hexagon hex, int){ dirty.push_back(hex); });
+        ASSERT_TRUE(dirty.empty());
+
+        // Reads do not mark cells dirty, writable access does.
+        const auto& cworld = world;
+        ASSERT_EQ(*cworld.find(Hexagon{1, 1}), 3);
+        ASSERT_EQ(world.get(Hexagon{-5, 9}), 2);
+        *world.find(Hexagon{-5, 9}) = 4;
+        world.for_each_dirty([&](Hexagon hex, int value)
+                             {
+                                     dirty.push_back(hex);
+                                     ASSERT_EQ(value, 4);
+                             });
+        ASSERT_EQ(dirty, (std::vector<Hexagon>{{-5, 9}}));
+
+        ASSERT_FALSE(world.cleared());
+        world.clear();
+        ASSERT_TRUE(world.cleared());
+        ASSERT_EQ(world.snapshot(), 2u);
+        ASSERT_FALSE(world.cleared());
+}
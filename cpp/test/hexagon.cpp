@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <hexagon.h>
 
+#include <random>
+
 using namespace Hex;
 
 TEST(Hexagon, Equality)
@@ -150,6 +152,37 @@ TEST(Hexagon, CartesianToHex)
         ASSERT_EQ(nearest_hex(p2), h2);
 }
 
+TEST(Hexagon, CartesianToHexIsClosestCenter)
+{
+        for(const auto& hex : spiral(Hexagon{0, 0}, 3)){
+                for(const auto& corner : hex.corners()){
+                        // Slightly inside the hexagon, towards each corner.
+                        const Point p = hex.to_point() + 0.9*(corner - hex.to_point());
+                        ASSERT_EQ(nearest_hex(p), hex);
+                }
+        }
+}
+
+TEST(Hexagon, NearestHexMatchesBruteForce)
+{
+        // Regression test: the rounding correction of nearest_hex used
+        // a + b + c = 0, while with c = b - a the constraint is a + c = b.
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> dist(-50, 50);
+        for(int i = 0; i < 10000; i++){
+                const Point p{dist(gen), dist(gen)};
+                const Hexagon res = nearest_hex(p);
+                const Point d = p - res.to_point();
+                const double distance2 = d.x*d.x + d.y*d.y;
+                // On the hexagonal lattice the center closest to p is the one
+                // no neighbour is closer than.
+                for(const auto& dir : neighbor_directions){
+                        const Point e = p - (res + dir).to_point();
+                        ASSERT_LE(distance2, e.x*e.x + e.y*e.y + 1e-12);
+                }
+        }
+}
+
 TEST(Hexagon, ToString)
 {
         Hexagon h1{1, 2};
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <hexagon.h>
+
+#include <cmath>
+#include <sstream>
+
+#ifndef HEX_INSTRUMENTATION
+#error "instrumentation tests must be built with HEX_INSTRUMENTATION"
+#endif
+
+using namespace Hex;
+
+TEST(Instrumentation, CountsNearestHexBranches)
+{
+        // The point with lattice coordinates (a, b), c = b - a.
+        const auto at = [](double a, double b)
+                        {
+                                return Point{a - b/2, std::sqrt(3.)/2*b};
+                        };
+        instrumentation::reset_counters();
+        // a is rounded the most (0.45 against 0.2 and 0.25).
+        nearest_hex(at(0.45, 0.2));
+        // b is rounded the most (0.45 against 0.1 and 0.35, 0.4 against 0.1
+        // and 0.3).
+        nearest_hex(at(0.1, 0.45));
+        nearest_hex(at(3.1, -1.6));
+        // c is rounded the most, or nothing is rounded.
+        nearest_hex(at(0.2, -0.2));
+        nearest_hex(at(0, 0));
+        nearest_hex(at(-2, 1));
+        ASSERT_EQ(instrumentation::counter("nearest_hex"), 6);
+        ASSERT_EQ(instrumentation::counter("nearest_hex.fix_a"), 1);
+        ASSERT_EQ(instrumentation::counter("nearest_hex.fix_b"), 2);
+        ASSERT_EQ(instrumentation::counter("nearest_hex.keep"), 3);
+}
+
+TEST(Instrumentation, CountsAllocatedBytes)
+{
+        instrumentation::reset_counters();
+        ring(Hexagon{0, 0}, 2);
+        ASSERT_EQ(instrumentation::counter("ring"), 1);
+        ASSERT_EQ(instrumentation::counter("ring", "bytes"), 12*sizeof(Hexagon));
+        spiral(Hexagon{0, 0}, 2);
+        ASSERT_EQ(instrumentation::counter("spiral", "bytes"), 19*sizeof(Hexagon));
+        // spiral calls ring for every radius
+        ASSERT_EQ(instrumentation::counter("ring"), 4);
+}
+
+TEST(Instrumentation, SinkReceivesEvents)
+{
+        std::vector<instrumentation::Event> events;
+        instrumentation::set_sink([&events](const instrumentation::Event& event)
+                                  {
+                                          events.push_back(event);
+                                  });
+        spiral(Hexagon{0, 0}, 1);
+        instrumentation::set_sink(nullptr);
+        spiral(Hexagon{0, 0}, 1);
+
+        ASSERT_FALSE(events.empty());
+        ASSERT_EQ(std::string(events.back().name), "spiral");
+        ASSERT_EQ(events.back().type, instrumentation::Event::Type::scope);
+        std::size_t allocations = 0;
+        for(const auto& event : events){
+                allocations += event.type == instrumentation::Event::Type::allocation;
+        }
+        // spiral itself, and ring for radius 1 (radius 0 does not allocate)
+        ASSERT_EQ(allocations, 2);
+}
+
+TEST(Instrumentation, ChromeTrace)
+{
+        std::ostringstream os;
+        {
+                instrumentation::set_sink(instrumentation::ChromeTraceSink(os));
+                spiral(Hexagon{0, 0}, 1);
+                instrumentation::set_sink(nullptr);
+        }
+        const std::string trace = os.str();
+        ASSERT_EQ(trace.front(), '[');
+        ASSERT_EQ(trace.substr(trace.size() - 3), "\n]\n");
+        ASSERT_NE(trace.find("\"name\": \"spiral\""), std::string::npos);
+        ASSERT_NE(trace.find("\"ph\": \"X\""), std::string::npos);
+}
+
+TEST(Instrumentation, ChromeTraceKeepsStreamFlags)
+{
+        std::ostringstream os;
+        os.precision(3);
+        const auto flags = os.flags();
+        {
+                instrumentation::set_sink(instrumentation::ChromeTraceSink(os));
+                spiral(Hexagon{0, 0}, 1);
+                instrumentation::set_sink(nullptr);
+        }
+        ASSERT_EQ(os.flags(), flags);
+        ASSERT_EQ(os.precision(), 3);
+}
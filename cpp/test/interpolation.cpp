@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <interpolation.h>
+
+#include <random>
+
+using namespace Hex;
+
+namespace{
+// A linear function of the hexagon center is reproduced exactly.
+double linear(Point p)
+{
+        return 2*p.x - 3*p.y + 1;
+}
+}
+
+TEST(Interpolation, TriangleIsNeighbours)
+{
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<double> dist(-10, 10);
+        for(int i = 0; i < 1000; i++){
+                const Point p{dist(gen), dist(gen)};
+                const auto t = locate_triangle(p);
+                ASSERT_EQ(manhattan_distance(t.hexes[0] - t.hexes[1]), 1);
+                ASSERT_EQ(manhattan_distance(t.hexes[1] - t.hexes[2]), 1);
+                ASSERT_EQ(manhattan_distance(t.hexes[2] - t.hexes[0]), 1);
+                Point q{0, 0};
+                for(int j = 0; j < 3; j++){
+                        ASSERT_GE(t.weights[j], 0);
+                        q += t.weights[j]*t.hexes[j].to_point();
+                }
+                ASSERT_NEAR(q.x, p.x, 1e-9);
+                ASSERT_NEAR(q.y, p.y, 1e-9);
+                // The nearest center has the largest weight.
+                const auto largest = std::max_element(t.weights.begin(), t.weights.end());
+                ASSERT_EQ(t.hexes[largest - t.weights.begin()], nearest_hex(p));
+        }
+}
+
+TEST(Interpolation, ExactAtCenters)
+{
+        auto value = [](Hexagon hex){ return 10.*hex.a + hex.b; };
+        for(const auto& hex : spiral(Hexagon{1, -2}, 2)){
+                ASSERT_NEAR(interpolate(value, hex.to_point()), value(hex), 1e-9);
+        }
+}
+
+TEST(Interpolation, BatchMatchesSingle)
+{
+        auto value = [](Hexagon hex){ return linear(hex.to_point()); };
+        std::mt19937 gen(2);
+        std::uniform_real_distribution<double> dist(-10, 10);
+        std::vector<Point> points(1000);
+        for(auto& p : points){
+                p = Point{dist(gen), dist(gen)};
+        }
+        std::vector<double> out(points.size());
+        interpolate(value, points.data(), out.data(), points.size());
+        for(std::size_t i = 0; i < points.size(); i++){
+                ASSERT_DOUBLE_EQ(out[i], interpolate(value, points[i]));
+                ASSERT_NEAR(out[i], linear(points[i]), 1e-9);
+        }
+}
+
+TEST(Interpolation, HexFieldClamps)
+{
+        HexField<int> field(Hexagon{0, 0}, 2, 2, 4);
+        field[Hexagon{1, 1}] = 8;
+        ASSERT_DOUBLE_EQ(interpolate(field, Hexagon{1, 1}.to_point()), 8);
+        ASSERT_DOUBLE_EQ(interpolate(field, Hexagon{5, 5}.to_point()), 8);
+        ASSERT_DOUBLE_EQ(interpolate(field, Hexagon{-3, 0}.to_point()), 4);
+        const double x[] = {0.5}, y[] = {0};
+        double out[1];
+        interpolate(field, x, y, out, 1);
+        ASSERT_DOUBLE_EQ(out[0], 4);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <outline.h>
+
+using namespace Hex;
+
+namespace{
+int count_holes(const std::vector<Outline>& res)
+{
+        int holes = 0;
+        for(const auto& outline : res){
+                holes += outline.hole;
+        }
+        return holes;
+}
+
+double signed_area(const Polyline& polyline)
+{
+        double res = 0;
+        for(const auto& edge : polyline.edges()){
+                res += edge.start.x*edge.stop.y - edge.stop.x*edge.start.y;
+        }
+        return res/2;
+}
+}
+
+TEST(Outline, SingleHexagon)
+{
+        const auto res = outlines(std::unordered_set<Hexagon>{Hexagon{2, 1}});
+        ASSERT_EQ(res.size(), 1);
+        ASSERT_FALSE(res[0].hole);
+        ASSERT_TRUE(res[0].boundary.closed);
+        ASSERT_EQ(res[0].boundary.points.size(), 6);
+        const auto corners = Hexagon{2, 1}.corners();
+        for(const auto& p : res[0].boundary.points){
+                ASSERT_NE(std::find(corners.begin(), corners.end(), p), corners.end());
+        }
+}
+
+TEST(Outline, DiskPerimeter)
+{
+        const auto cells = spiral(Hexagon{0, 0}, 3);
+        const auto res = outlines(std::unordered_set<Hexagon>(cells.begin(), cells.end()));
+        ASSERT_EQ(res.size(), 1);
+        ASSERT_FALSE(res[0].hole);
+        // Every ring cell contributes 2 sides, plus one extra for each of
+        // the 6 corner cells.
+        ASSERT_EQ(res[0].boundary.points.size(), 6*(2*3 + 1));
+        ASSERT_GT(signed_area(res[0].boundary), 0);
+}
+
+TEST(Outline, RingHasHole)
+{
+        const auto cells = ring(Hexagon{0, 0}, 2);
+        const auto res = outlines(std::unordered_set<Hexagon>(cells.begin(), cells.end()));
+        ASSERT_EQ(res.size(), 2);
+        ASSERT_EQ(count_holes(res), 1);
+        for(const auto& outline : res){
+                ASSERT_EQ(outline.hole, signed_area(outline.boundary) < 0);
+        }
+}
+
+TEST(Outline, SeparateRegions)
+{
+        std::unordered_set<Hexagon> cells{Hexagon{0, 0}, Hexagon{1, 0}, Hexagon{10, 10}};
+        const auto res = outlines(cells);
+        ASSERT_EQ(res.size(), 2);
+        ASSERT_EQ(count_holes(res), 0);
+        std::size_t points = res[0].boundary.points.size() +
+                             res[1].boundary.points.size();
+        ASSERT_EQ(points, 10 + 6);
+}
+
+TEST(Outline, TraceFromPredicate)
+{
+        auto inside = [](Hexagon hex){ return manhattan_distance(hex) <= 5; };
+        const auto res = trace_outline(Hexagon{5, 0}, 0, inside);
+        ASSERT_FALSE(res.hole);
+        ASSERT_EQ(res.boundary.points.size(), 6*(2*5 + 1));
+        ASSERT_EQ(res.boundary.edges().size(), res.boundary.points.size());
+}
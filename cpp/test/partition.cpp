@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <partition.h>
+
+#include <thread>
+#include <unordered_set>
+
+using namespace Hex;
+
+namespace{
+std::vector<Hexagon> parallelogram(int width, int height)
+{
+        std::vector<Hexagon> res;
+        for(int b = 0; b < height; b++){
+                for(int a = 0; a < width; a++){
+                        res.push_back(Hexagon{a, b});
+                }
+        }
+        return res;
+}
+}
+
+TEST(Partition, Balanced)
+{
+        const auto cells = spiral(Hexagon{3, -2}, 20);
+        const Partition partition(cells, 7);
+        ASSERT_EQ(partition.parts(), 7);
+        std::size_t total = 0, smallest = cells.size(), largest = 0;
+        for(int rank = 0; rank < 7; rank++){
+                const auto& subdomain = partition.subdomain(rank);
+                ASSERT_EQ(subdomain.rank, rank);
+                for(const auto& hex : subdomain.cells){
+                        ASSERT_EQ(partition.owner(hex), rank);
+                }
+                total += subdomain.cells.size();
+                smallest = std::min(smallest, subdomain.cells.size());
+                largest = std::max(largest, subdomain.cells.size());
+        }
+        ASSERT_EQ(total, cells.size());
+        ASSERT_LE(largest - smallest, 2u);
+        ASSERT_EQ(partition.owner(Hexagon{100, 100}), -1);
+        ASSERT_THROW(Partition(cells, 0), std::invalid_argument);
+}
+
+TEST(Partition, Compact)
+{
+        // Compact parts have halos of the order of their perimeter, a strip
+        // through the whole region would have 128.
+        const Partition partition(parallelogram(64, 64), 4);
+        for(int rank = 0; rank < 4; rank++){
+                const auto& subdomain = partition.subdomain(rank);
+                ASSERT_EQ(subdomain.cells.size(), 32u*32u);
+                std::size_t ghosts = 0;
+                for(const auto& halo : subdomain.halos){
+                        ghosts += halo.receive.size();
+                }
+                ASSERT_LT(ghosts, 100u);
+        }
+}
+
+TEST(Partition, HalosAreSymmetric)
+{
+        const Partition partition(parallelogram(30, 17), 5);
+        for(int rank = 0; rank < 5; rank++){
+                const auto& subdomain = partition.subdomain(rank);
+                ASSERT_FALSE(subdomain.halos.empty());
+                for(const auto& halo : subdomain.halos){
+                        ASSERT_NE(halo.neighbor, rank);
+                        const auto& other = partition.subdomain(halo.neighbor);
+                        const auto it = std::find_if(other.halos.begin(), other.halos.end(),
+                                                     [rank](const Halo& h){ return h.neighbor == rank; });
+                        ASSERT_NE(it, other.halos.end());
+                        ASSERT_EQ(it->send, halo.receive);
+                        ASSERT_EQ(it->receive, halo.send);
+                        for(const auto& hex : halo.receive){
+                                ASSERT_EQ(partition.owner(hex), halo.neighbor);
+                        }
+                }
+        }
+}
+
+TEST(Partition, ExchangeBetweenThreads)
+{
+        const int parts = 6;
+        const Partition partition(parallelogram(40, 25), parts);
+        MailboxTransport transport;
+        std::vector<std::unordered_map<Hexagon, double>> data(parts);
+        const auto value = [](Hexagon hex){ return hex.a*0.5 - hex.b; };
+        std::vector<std::thread> ranks;
+        for(int rank = 0; rank < parts; rank++){
+                ranks.emplace_back([&, rank]
+                {
+                        auto& local = data[rank];
+                        const auto& subdomain = partition.subdomain(rank);
+                        for(const auto& hex : subdomain.cells){
+                                local[hex] = value(hex);
+                        }
+                        // Two rounds, to check that messages stay in order.
+                        for(int round = 0; round < 2; round++){
+                                exchange_halo<double>(subdomain, transport,
+                                        [&](Hexagon hex){ return local.at(hex) + round; },
+                                        [&](Hexagon hex, double v){ local[hex] = v; });
+                        }
+                });
+        }
+        for(auto& thread : ranks){
+                thread.join();
+        }
+        for(int rank = 0; rank < parts; rank++){
+                for(const auto& halo : partition.subdomain(rank).halos){
+                        for(const auto& hex : halo.receive){
+                                ASSERT_EQ(data[rank].at(hex), value(hex) + 1);
+                        }
+                }
+        }
+}
+
+TEST(Partition, UnpackChecksSize)
+{
+        const std::vector<Hexagon> cells{{0, 0}, {1, 0}};
+        const auto buffer = pack_halo<int>(cells, [](Hexagon hex){ return hex.a; });
+        ASSERT_EQ(buffer.size(), 2*sizeof(int));
+        ASSERT_THROW(unpack_halo<int>(std::vector<Hexagon>{{0, 0}}, buffer,
+                                      [](Hexagon, int){}),
+                     std::invalid_argument);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <periodic.h>
+
+#include <random>
+
+using namespace Hex;
+
+namespace{
+// Steps from p to q on the grid, by breadth first search over the neighbour
+// table.
+int graph_distance(const PeriodicHexDomain& domain, Hexagon p, Hexagon q)
+{
+        std::vector<int> distances(domain.size(), -1);
+        std::vector<std::size_t> queue{domain.index(p)};
+        distances[queue.front()] = 0;
+        for(std::size_t k = 0; k < queue.size(); k++){
+                for(int dir = 0; dir < 6; dir++){
+                        const std::size_t next = domain.neighbor(queue[k], dir);
+                        if(distances[next] < 0){
+                                distances[next] = distances[queue[k]] + 1;
+                                queue.push_back(next);
+                        }
+                }
+        }
+        return distances[domain.index(q)];
+}
+}
+
+TEST(Periodic, NormalForm)
+{
+        const PeriodicHexDomain rectangle(Hexagon{4, 0}, Hexagon{0, 3});
+        ASSERT_EQ(rectangle.width(), 4);
+        ASSERT_EQ(rectangle.height(), 3);
+        ASSERT_EQ(rectangle.shift(), 0);
+        ASSERT_EQ(rectangle.size(), 12u);
+
+        const PeriodicHexDomain skewed(Hexagon{5, 2}, Hexagon{-1, 3});
+        ASSERT_EQ(skewed.size(), 17u);
+        ASSERT_EQ(skewed.height(), 1);
+        ASSERT_EQ(skewed.width(), 17);
+
+        ASSERT_THROW(PeriodicHexDomain(Hexagon{2, 4}, Hexagon{-1, -2}), std::invalid_argument);
+}
+
+TEST(Periodic, Canonical)
+{
+        const Hexagon u{7, 3}, v{-2, 5};
+        const PeriodicHexDomain domain(u, v);
+        ASSERT_EQ(domain.size(), 41u);
+        for(std::size_t i = 0; i < domain.size(); i++){
+                const Hexagon hex = domain.hex(i);
+                ASSERT_EQ(domain.canonical(hex), hex);
+                ASSERT_EQ(domain.index(hex), i);
+                for(int k = -3; k <= 3; k++){
+                        ASSERT_EQ(domain.canonical(hex + u*k - v*(2*k + 1)), hex);
+                }
+        }
+}
+
+TEST(Periodic, Distance)
+{
+        std::mt19937 rng(3);
+        std::uniform_int_distribution<int> coordinate(-50, 50);
+        const std::vector<std::pair<Hexagon, Hexagon>> lattices{
+                {Hexagon{10, 0}, Hexagon{0, 8}},
+                {Hexagon{7, 3}, Hexagon{-2, 5}},
+                {Hexagon{100, 0}, Hexagon{99, 1}},
+                {Hexagon{12, 12}, Hexagon{12, 0}}};
+        for(const auto& lattice : lattices){
+                const PeriodicHexDomain domain(lattice.first, lattice.second);
+                for(int k = 0; k < 50; k++){
+                        const Hexagon p{coordinate(rng), coordinate(rng)};
+                        const Hexagon q{coordinate(rng), coordinate(rng)};
+                        const Hexagon d = domain.displacement(p, q);
+                        ASSERT_EQ(domain.canonical(p + d), domain.canonical(q));
+                        ASSERT_EQ(domain.distance(p, q),
+                                  graph_distance(domain, p, q));
+                }
+        }
+}
+
+TEST(Periodic, RingsAndSpirals)
+{
+        const PeriodicHexDomain large(Hexagon{50, 0}, Hexagon{0, 50});
+        const auto ring = large.ring(Hexagon{-1, 2}, 5);
+        ASSERT_EQ(ring.size(), 30u);
+        for(const auto& hex : ring){
+                ASSERT_EQ(large.canonical(hex), hex);
+                ASSERT_EQ(large.distance(Hexagon{-1, 2}, hex), 5);
+        }
+
+        // On a small torus the spiral covers every cell exactly once.
+        const PeriodicHexDomain small(Hexagon{6, 0}, Hexagon{3, 5});
+        const auto all = small.spiral(Hexagon{2, 2}, 10);
+        ASSERT_EQ(all.size(), small.size());
+        int last = 0;
+        for(const auto& hex : all){
+                const int d = small.distance(Hexagon{2, 2}, hex);
+                ASSERT_GE(d, last);
+                last = d;
+        }
+        std::size_t total = 0;
+        for(int r = 0; r <= 10; r++){
+                total += small.ring(Hexagon{2, 2}, r).size();
+        }
+        ASSERT_EQ(total, small.size());
+}
+
+TEST(Periodic, NeighborTable)
+{
+        const PeriodicHexDomain domain(Hexagon{9, 0}, Hexagon{4, 6});
+        ASSERT_EQ(domain.neighbor_table().size(), 6*domain.size());
+        for(std::size_t i = 0; i < domain.size(); i++){
+                for(int dir = 0; dir < 6; dir++){
+                        ASSERT_EQ(domain.neighbor(i, dir),
+                                  domain.index(domain.hex(i) + neighbor_directions[dir]));
+                        ASSERT_EQ(domain.neighbor(domain.neighbor(i, dir), (dir + 3) % 6), i);
+                }
+        }
+}
+
+TEST(Periodic, ShearedWrapVectors)
+{
+        // Lattices whose basis reduction hits rounding ties or needs many
+        // steps.
+        const std::vector<std::pair<Hexagon, Hexagon>> lattices{
+                {Hexagon{9, -12}, Hexagon{-10, 11}},
+                {Hexagon{1, 1}, Hexagon{11, -10}},
+                {Hexagon{50, 0}, Hexagon{0, 50}},
+                {Hexagon{101, 100}, Hexagon{100, 99}},
+                {Hexagon{-7, 13}, Hexagon{6, -11}}};
+        for(const auto& lattice : lattices){
+                const PeriodicHexDomain domain(lattice.first, lattice.second);
+                const long long det = static_cast<long long>(lattice.first.a)*lattice.second.b -
+                                      static_cast<long long>(lattice.first.b)*lattice.second.a;
+                ASSERT_EQ(domain.size(), static_cast<std::size_t>(std::llabs(det)));
+                for(std::size_t i = 0; i < domain.size(); i += 3){
+                        ASSERT_EQ(domain.distance(Hexagon{0, 0}, domain.hex(i)),
+                                  graph_distance(domain, Hexagon{0, 0}, domain.hex(i)));
+                }
+        }
+
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<int> coordinate(-15, 15);
+        for(int k = 0; k < 500; k++){
+                const Hexagon u{coordinate(rng), coordinate(rng)};
+                const Hexagon v{coordinate(rng), coordinate(rng)};
+                if(static_cast<long long>(u.a)*v.b == static_cast<long long>(u.b)*v.a){
+                        continue;
+                }
+                const PeriodicHexDomain domain(u, v);
+                const Hexagon q = domain.hex(domain.size()/2);
+                ASSERT_EQ(domain.distance(Hexagon{0, 0}, q),
+                          graph_distance(domain, Hexagon{0, 0}, q));
+        }
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <point_index.h>
+
+#include <random>
+#include <numeric>
+#include <limits>
+#include <stdexcept>
+
+using namespace Hex;
+
+namespace{
+std::vector<Point> random_points(std::size_t n, unsigned seed)
+{
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> dist(-20, 20);
+        std::vector<Point> res(n);
+        for(auto& p : res){
+                p = Point{dist(gen), dist(gen)};
+        }
+        return res;
+}
+
+double distance(Point a, Point b)
+{
+        return std::hypot(a.x - b.x, a.y - b.y);
+}
+}
+
+TEST(PointIndex, Empty)
+{
+        PointIndex index({}, 1.);
+        ASSERT_TRUE(index.radius_query(Point{0, 0}, 10).empty());
+        ASSERT_TRUE(index.nearest(Point{0, 0}, 3).empty());
+}
+
+TEST(PointIndex, RadiusQueryMatchesBruteForce)
+{
+        const auto points = random_points(2000, 1);
+        PointIndex index(points, 1.5, 4);
+        ASSERT_EQ(index.size(), points.size());
+        for(const auto& q : random_points(50, 2)){
+                for(double radius : {0.3, 2., 7.}){
+                        auto res = index.radius_query(q, radius);
+                        std::sort(res.begin(), res.end());
+                        std::vector<std::size_t> answer;
+                        for(std::size_t i = 0; i < points.size(); i++){
+                                if(distance(points[i], q) <= radius){
+                                        answer.push_back(i);
+                                }
+                        }
+                        ASSERT_EQ(res, answer);
+                }
+        }
+}
+
+TEST(PointIndex, RadiusQueryHugeRadius)
+{
+        const auto points = random_points(500, 5);
+        PointIndex index(points, 1.);
+        for(double radius : {1e12, 1e300,
+                             std::numeric_limits<double>::infinity()}){
+                ASSERT_EQ(index.radius_query(Point{3, -4}, radius).size(),
+                          points.size());
+        }
+}
+
+TEST(PointIndex, NearestMatchesBruteForce)
+{
+        const auto points = random_points(2000, 3);
+        PointIndex index(points, 1., 3);
+        for(const auto& q : random_points(50, 4)){
+                const auto res = index.nearest(q, 10);
+                std::vector<std::size_t> answer(points.size());
+                std::iota(answer.begin(), answer.end(), 0);
+                std::sort(answer.begin(), answer.end(),
+                          [&](std::size_t a, std::size_t b)
+                          {
+                                  return distance(points[a], q) < distance(points[b], q);
+                          });
+                answer.resize(10);
+                ASSERT_EQ(res, answer);
+        }
+}
+
+TEST(PointIndex, NearestFarAway)
+{
+        const std::vector<Point> points{{0, 0}, {1, 0}, {5, 5}};
+        PointIndex index(points, 0.5, 1);
+        const std::vector<std::size_t> answer{2, 1, 0};
+        ASSERT_EQ(index.nearest(Point{100, 100}, 5), answer);
+}
+
+TEST(PointIndex, OutlierWithManyThreads)
+{
+        // A far outlier makes the bounding parallelogram large compared to
+        // the number of points, the build must not scale it by the threads.
+        auto points = random_points(300, 6);
+        points.push_back(Point{400, -300});
+        const PointIndex serial(points, 0.5, 1), threaded(points, 0.5, 32);
+        for(const auto& q : random_points(20, 7)){
+                auto res = threaded.radius_query(q, 3.);
+                auto answer = serial.radius_query(q, 3.);
+                std::sort(res.begin(), res.end());
+                std::sort(answer.begin(), answer.end());
+                ASSERT_EQ(res, answer);
+                ASSERT_EQ(threaded.nearest(q, 5), serial.nearest(q, 5));
+        }
+        const std::vector<std::size_t> outlier{points.size() - 1};
+        ASSERT_EQ(threaded.nearest(Point{390, -290}, 1), outlier);
+}
+
+TEST(PointIndex, InvalidCellSize)
+{
+        const auto points = random_points(10, 8);
+        for(double cell_size : {0., -1., std::numeric_limits<double>::quiet_NaN(),
+                                std::numeric_limits<double>::infinity()}){
+                ASSERT_THROW(PointIndex(points, cell_size), std::invalid_argument);
+        }
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <rasterizer.h>
+
+#include <vector>
+
+using namespace Hex;
+
+namespace{
+int id(Hexagon hex)
+{
+        return hex.a*1000 + hex.b;
+}
+}
+
+TEST(Rasterizer, MatchesNearestHex)
+{
+        const int width = 300, height = 200;
+        for(double scale : {0.013, 0.11, 0.7, 2.3}){
+                const RasterView view{Point{-3.1234, 1.777}, scale, -scale};
+                std::vector<int> image(width*height);
+                rasterize(id, view, image.data(), width, height, width, false, 3);
+                for(int j = 0; j < height; j++){
+                        for(int i = 0; i < width; i++){
+                                const Point p{view.origin.x + i*view.pixel_width,
+                                              view.origin.y + j*view.pixel_height};
+                                ASSERT_EQ(image[i + j*width], id(nearest_hex(p)))
+                                        << "pixel " << i << ", " << j;
+                        }
+                }
+        }
+}
+
+TEST(Rasterizer, Stride)
+{
+        const RasterView view{Point{0.3, 0.1}, 0.25, 0.25};
+        std::vector<float> image(10*3, -1.f);
+        rasterize([](Hexagon hex){ return static_cast<float>(hex.a); },
+                  view, image.data(), 7, 3, 10);
+        for(int j = 0; j < 3; j++){
+                for(int i = 7; i < 10; i++){
+                        ASSERT_EQ(image[i + 10*j], -1.f);
+                }
+        }
+        ASSERT_EQ(image[0], 0.f);
+}
+
+TEST(Rasterizer, AntialiasRGBA)
+{
+        HexField<RGBA> field(Hexagon{-10, -10}, 20, 20);
+        for(std::size_t i = 0; i < field.size(); i++){
+                const Hexagon hex = field.hex(i);
+                field.values()[i] = (hex.a + hex.b) % 2 ? RGBA{255, 0, 0, 255} :
+                                                          RGBA{0, 0, 255, 255};
+        }
+        const int width = 256, height = 128;
+        const RasterView view{Point{-2.0123, -1.0031}, 1./64, 1./64};
+        std::vector<RGBA> plain(width*height), smooth(width*height);
+        rasterize(field, RGBA{}, view, plain.data(), width, height, width);
+        rasterize(field, RGBA{}, view, smooth.data(), width, height, width, true);
+        int blended = 0;
+        for(int k = 0; k < width*height; k++){
+                ASSERT_EQ(smooth[k].a, 255);
+                ASSERT_NEAR(smooth[k].r + smooth[k].b, 255, 1);
+                if(smooth[k] != plain[k]){
+                        blended++;
+                        // Only pixels next to a color change are blended.
+                        const int i = k % width;
+                        ASSERT_TRUE((i > 0 && plain[k - 1] != plain[k]) ||
+                                    (i < width - 1 && plain[k + 1] != plain[k]));
+                }
+        }
+        ASSERT_GT(blended, 0);
+}
+
+TEST(Rasterizer, Blend)
+{
+        ASSERT_EQ(detail::blend(0, 10, 0.25), 3);
+        ASSERT_DOUBLE_EQ(detail::blend(1., 3., 0.5), 2.);
+        ASSERT_EQ(detail::blend(RGBA{0, 100, 200, 255}, RGBA{100, 100, 0, 255}, 0.5),
+                  (RGBA{50, 100, 100, 255}));
+}
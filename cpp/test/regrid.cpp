@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <regrid.h>
+
+using namespace Hex;
+
+TEST(Regrid, LayoutRoundTrip)
+{
+        HexLayout layout{2.5, 0.3, Point{1, -4}};
+        for(const auto& hex : spiral(Hexagon{3, 1}, 3)){
+                ASSERT_EQ(layout.nearest(layout.to_point(hex)), hex);
+        }
+}
+
+TEST(Regrid, IntersectionArea)
+{
+        const auto corners = Hexagon{0, 0}.corners();
+        ASSERT_NEAR(detail::intersection_area(corners, corners), std::sqrt(3.)/2, 1e-12);
+        ASSERT_NEAR(detail::intersection_area(corners, Hexagon{1, 0}.corners()), 0, 1e-12);
+}
+
+TEST(Regrid, SameLayoutIsIdentity)
+{
+        const LayoutRegion region{HexLayout{}, Hexagon{-2, -2}, 5, 4};
+        for(auto method : {RegridMethod::conservative, RegridMethod::nearest}){
+                Regridder regridder(region, region, method, 2);
+                ASSERT_EQ(regridder.columns().size(), region.size());
+                HexField<int> field(region.origin, region.width, region.height);
+                for(std::size_t i = 0; i < field.size(); i++){
+                        field.values()[i] = static_cast<int>(i);
+                }
+                const auto res = regridder.apply(field);
+                for(std::size_t i = 0; i < res.size(); i++){
+                        ASSERT_NEAR(res.values()[i], field.values()[i], 1e-9);
+                }
+        }
+}
+
+TEST(Regrid, ConservativeRotatedAndScaled)
+{
+        // A fine source grid covering a coarse, rotated target grid.
+        const LayoutRegion src{HexLayout{0.4, 0, Point{0, 0}}, Hexagon{-40, -40}, 80, 80};
+        const LayoutRegion dst{HexLayout{1.3, 0.5, Point{0.2, 0.1}}, Hexagon{-3, -3}, 6, 6};
+        Regridder regridder(src, dst, RegridMethod::conservative);
+        for(std::size_t row = 0; row < dst.size(); row++){
+                double sum = 0;
+                for(std::size_t k = regridder.row_offsets()[row];
+                    k < regridder.row_offsets()[row + 1]; k++){
+                        sum += regridder.weights()[k];
+                }
+                ASSERT_NEAR(sum, 1., 1e-12);
+        }
+        HexField<double> constant(src.origin, src.width, src.height, 3.5);
+        const auto regridded = regridder.apply(constant, 0., 3);
+        for(const auto& value : regridded.values()){
+                ASSERT_NEAR(value, 3.5, 1e-12);
+        }
+        // A linear field keeps its value at the target centers (overlaps are
+        // symmetric around the center up to the source resolution).
+        HexField<double> linear(src.origin, src.width, src.height);
+        for(std::size_t i = 0; i < linear.size(); i++){
+                linear.values()[i] = src.layout.to_point(linear.hex(i)).x;
+        }
+        const auto res = regridder.apply(linear);
+        for(std::size_t i = 0; i < res.size(); i++){
+                ASSERT_NEAR(res.values()[i], dst.layout.to_point(res.hex(i)).x, 0.1);
+        }
+}
+
+TEST(Regrid, OutsideSourceGetsFallback)
+{
+        const LayoutRegion src{HexLayout{}, Hexagon{0, 0}, 2, 2};
+        const LayoutRegion dst{HexLayout{1, 0, Point{100, 100}}, Hexagon{0, 0}, 2, 2};
+        Regridder regridder(src, dst, RegridMethod::nearest);
+        HexField<double> field(src.origin, src.width, src.height, 1.);
+        const auto res = regridder.apply(field, -1.);
+        for(const auto& value : res.values()){
+                ASSERT_EQ(value, -1.);
+        }
+}
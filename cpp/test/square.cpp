@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <square.h>
+
+using namespace Hex;
+
+TEST(Square, Equality)
+{
+        Square s1, s2{0, 0};
+        ASSERT_EQ(s1, s2);
+}
+
+TEST(Square, Inequality)
+{
+        Square s1, s2{1, 1};
+        ASSERT_NE(s1, s2);
+}
+
+TEST(Square, Addition)
+{
+        Square s1{1, 2}, s2{3, -1}, s3{4, 1};
+        ASSERT_EQ(s1 + s2, s3);
+}
+
+TEST(Square, Rotate90)
+{
+        Square s1{1, 0}, s2{0, 1};
+        ASSERT_EQ(rotate(s1), s2);
+}
+
+TEST(Square, RotateAndRotateBack)
+{
+        Square s1{2, 3};
+        ASSERT_EQ(rotate_clockwise(rotate(s1)), s1);
+}
+
+TEST(Square, Distances)
+{
+        Square s1{2, -3};
+        ASSERT_EQ(manhattan_distance(s1), 5);
+        ASSERT_EQ(chebyshev_distance(s1), 3);
+        ASSERT_EQ(euclidean_distance(s1), std::sqrt(13));
+}
+
+TEST(Square, CartesianToSquare)
+{
+        Point p1{0.6, -1.4};
+        Square s1{1, -1};
+        ASSERT_EQ(nearest_square(p1), s1);
+}
+
+TEST(Square, Corners)
+{
+        Square s{1, 2};
+        std::array<Point, 4> answer{
+                Point{1.5, 2.5}, Point{0.5, 2.5},
+                Point{0.5, 1.5}, Point{1.5, 1.5}
+        };
+        ASSERT_EQ(s.corners(), answer);
+}
+
+TEST(Square, ToString)
+{
+        Square s1{1, 2};
+        ASSERT_EQ(s1.to_string(), "Square(1, 2)");
+}
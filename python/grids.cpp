@@ -0,0 +1,248 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/operators.h>
+#include <pybind11/stl.h>
+
+#include <stdexcept>
+
+#include <point.h>
+#include <edge.h>
+#include <hexagon.h>
+#include <parallel.h>
+
+namespace py = pybind11;
+using namespace Hex;
+
+namespace{
+/*******************************************************************************
+ * Arrays of points are float64 arrays of shape (n, 2), arrays of hexagons are
+ * int32 arrays of shape (n, 2). Arrays that already have the right dtype and
+ * are C-contiguous are used in place, anything else is converted by NumPy.
+ ******************************************************************************/
+using point_array = py::array_t<double, py::array::c_style | py::array::forcecast>;
+using hex_array = py::array_t<int, py::array::c_style | py::array::forcecast>;
+
+py::ssize_t pair_count(const py::array& array, const char* name)
+{
+        if(array.ndim() != 2 || array.shape(1) != 2){
+                throw std::invalid_argument(std::string(name) +
+                                            " must have shape (n, 2)");
+        }
+        return array.shape(0);
+}
+
+hex_array batch_nearest_hex(point_array points, unsigned num_threads)
+{
+        const py::ssize_t n = pair_count(points, "points");
+        hex_array res({n, static_cast<py::ssize_t>(2)});
+        const double* src = points.data();
+        int* dst = res.mutable_data();
+        {
+                py::gil_scoped_release release;
+                parallel_for(static_cast<std::size_t>(n), num_threads,
+                             [src, dst](std::size_t i)
+                             {
+                                     const Hexagon hex = nearest_hex(
+                                             Point{src[2*i], src[2*i + 1]});
+                                     dst[2*i] = hex.a;
+                                     dst[2*i + 1] = hex.b;
+                             });
+        }
+        return res;
+}
+
+point_array batch_to_point(hex_array hexes, unsigned num_threads)
+{
+        const py::ssize_t n = pair_count(hexes, "hexes");
+        point_array res({n, static_cast<py::ssize_t>(2)});
+        const int* src = hexes.data();
+        double* dst = res.mutable_data();
+        {
+                py::gil_scoped_release release;
+                parallel_for(static_cast<std::size_t>(n), num_threads,
+                             [src, dst](std::size_t i)
+                             {
+                                     const Point p = Hexagon{src[2*i],
+                                                             src[2*i + 1]}.to_point();
+                                     dst[2*i] = p.x;
+                                     dst[2*i + 1] = p.y;
+                             });
+        }
+        return res;
+}
+
+py::array_t<int> batch_manhattan_distance(hex_array hexes, unsigned num_threads)
+{
+        const py::ssize_t n = pair_count(hexes, "hexes");
+        py::array_t<int> res(n);
+        const int* src = hexes.data();
+        int* dst = res.mutable_data();
+        {
+                py::gil_scoped_release release;
+                parallel_for(static_cast<std::size_t>(n), num_threads,
+                             [src, dst](std::size_t i)
+                             {
+                                     dst[i] = manhattan_distance(
+                                             Hexagon{src[2*i], src[2*i + 1]});
+                             });
+        }
+        return res;
+}
+
+/*******************************************************************************
+ * Return an int32 array of shape (n, len(offsets), 2) holding
+ * centers[i] + offsets[j].
+ ******************************************************************************/
+hex_array batch_offsets(hex_array centers, const std::vector<Hexagon>& offsets,
+                        unsigned num_threads)
+{
+        const py::ssize_t n = pair_count(centers, "centers");
+        const py::ssize_t m = static_cast<py::ssize_t>(offsets.size());
+        hex_array res({n, m, static_cast<py::ssize_t>(2)});
+        const int* src = centers.data();
+        int* dst = res.mutable_data();
+        const Hexagon* offset = offsets.data();
+        {
+                py::gil_scoped_release release;
+                parallel_for(static_cast<std::size_t>(n), num_threads,
+                             [src, dst, offset, m](std::size_t i)
+                             {
+                                     const Hexagon center{src[2*i], src[2*i + 1]};
+                                     int* out = dst + 2*m*i;
+                                     for(py::ssize_t j = 0; j < m; j++){
+                                             const Hexagon hex = center + offset[j];
+                                             out[2*j] = hex.a;
+                                             out[2*j + 1] = hex.b;
+                                     }
+                             });
+        }
+        return res;
+}
+}
+
+PYBIND11_MODULE(grids, m)
+{
+        m.doc() = "Grids/maps of various geometric shapes (starting with "
+                  "hexagons). Batch functions take and return NumPy arrays, "
+                  "release the GIL and run on num_threads threads (0 means "
+                  "one per hardware thread).";
+
+        py::class_<Point>(m, "Point")
+                .def(py::init<>())
+                .def(py::init([](double x, double y){ return Point{x, y}; }),
+                     py::arg("x"), py::arg("y"))
+                .def_readwrite("x", &Point::x)
+                .def_readwrite("y", &Point::y)
+                .def(py::self + py::self)
+                .def(py::self - py::self)
+                .def(py::self * double())
+                .def(double() * py::self)
+                .def(py::self / double())
+                .def(-py::self)
+                .def(py::self == py::self)
+                .def(py::self != py::self)
+                .def("__repr__", &Point::to_string);
+
+        py::class_<Edge>(m, "Edge")
+                .def(py::init([](Point start, Point stop)
+                              {
+                                      return Edge{start, stop};
+                              }),
+                     py::arg("start"), py::arg("stop"))
+                .def_readwrite("start", &Edge::start)
+                .def_readwrite("stop", &Edge::stop)
+                .def("at", &Edge::at, py::arg("t"))
+                .def(py::self == py::self)
+                .def(py::self != py::self)
+                .def("__repr__", &Edge::to_string);
+
+        py::class_<Hexagon>(m, "Hexagon")
+                .def(py::init<>())
+                .def(py::init([](int a, int b){ return Hexagon{a, b}; }),
+                     py::arg("a"), py::arg("b"))
+                .def_readwrite("a", &Hexagon::a)
+                .def_readwrite("b", &Hexagon::b)
+                .def("to_point", &Hexagon::to_point)
+                .def("corners", &Hexagon::corners)
+                .def("edges", &Hexagon::edges)
+                .def("wedges", &Hexagon::wedges)
+                .def(py::self + py::self)
+                .def(py::self - py::self)
+                .def(py::self * int())
+                .def(int() * py::self)
+                .def(py::self / int())
+                .def(-py::self)
+                .def(py::self == py::self)
+                .def(py::self != py::self)
+                .def("__hash__", [](Hexagon hex)
+                                 {
+                                         return std::hash<Hexagon>()(hex);
+                                 })
+                .def("__repr__", &Hexagon::to_string);
+
+        m.attr("neighbor_directions") = neighbor_directions;
+
+        m.def("rotate", static_cast<Hexagon (*)(Hexagon)>(&rotate),
+              py::arg("hex"));
+        m.def("rotate", static_cast<Hexagon (*)(Hexagon, double)>(&rotate),
+              py::arg("hex"), py::arg("theta"));
+        m.def("rotate_clockwise",
+              static_cast<Hexagon (*)(Hexagon)>(&rotate_clockwise),
+              py::arg("hex"));
+        m.def("rotate_clockwise",
+              static_cast<Hexagon (*)(Hexagon, double)>(&rotate_clockwise),
+              py::arg("hex"), py::arg("theta"));
+        m.def("euclidean_distance", &euclidean_distance, py::arg("hex"));
+
+        // Scalar versions first, NumPy batch versions as overloads.
+        m.def("nearest_hex", &nearest_hex, py::arg("point"));
+        m.def("nearest_hex", &batch_nearest_hex, py::arg("points"),
+              py::arg("num_threads") = 0u,
+              "Return an int32 array (n, 2) of the hexagons nearest to the "
+              "float64 points (n, 2).");
+
+        m.def("to_point", [](Hexagon hex){ return hex.to_point(); },
+              py::arg("hex"));
+        m.def("to_point", &batch_to_point, py::arg("hexes"),
+              py::arg("num_threads") = 0u,
+              "Return a float64 array (n, 2) of the centers of the int32 "
+              "hexagons (n, 2).");
+
+        m.def("manhattan_distance", &manhattan_distance, py::arg("hex"));
+        m.def("manhattan_distance", &batch_manhattan_distance,
+              py::arg("hexes"), py::arg("num_threads") = 0u,
+              "Return an int32 array (n,) of the manhattan distances of the "
+              "int32 hexagons (n, 2).");
+
+        m.def("ring", [](Hexagon center, int radius)
+                      {
+                              return ring(center, radius);
+                      },
+              py::arg("center"), py::arg("radius"));
+        m.def("ring", [](hex_array centers, int radius, unsigned num_threads)
+                      {
+                              return batch_offsets(centers,
+                                                   ring(Hexagon{0, 0}, radius),
+                                                   num_threads);
+                      },
+              py::arg("centers"), py::arg("radius"),
+              py::arg("num_threads") = 0u,
+              "Return an int32 array (n, ring size, 2) with the ring around "
+              "each of the int32 centers (n, 2).");
+
+        m.def("spiral", [](Hexagon center, int radius)
+                        {
+                                return spiral(center, radius);
+                        },
+              py::arg("center"), py::arg("radius"));
+        m.def("spiral", [](hex_array centers, int radius, unsigned num_threads)
+                        {
+                                return batch_offsets(centers,
+                                                     spiral(Hexagon{0, 0}, radius),
+                                                     num_threads);
+                        },
+              py::arg("centers"), py::arg("radius"),
+              py::arg("num_threads") = 0u,
+              "Return an int32 array (n, spiral size, 2) with the spiral "
+              "around each of the int32 centers (n, 2).");
+}
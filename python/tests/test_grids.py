@@ -0,0 +1,109 @@
+"""Smoke tests of the grids Python module: the bound types and the NumPy batch
+functions, checked against the scalar versions."""
+import math
+import unittest
+
+import numpy as np
+
+import grids
+
+
+class TypesTest(unittest.TestCase):
+    def test_point(self):
+        p = grids.Point(1.5, -2)
+        self.assertEqual((p.x, p.y), (1.5, -2))
+        self.assertEqual(p + grids.Point(1, 1), grids.Point(2.5, -1))
+        self.assertEqual(p - p, grids.Point())
+        self.assertEqual(2*p, p*2)
+        self.assertEqual(p/2, grids.Point(0.75, -1))
+        self.assertEqual(-p, grids.Point(-1.5, 2))
+        self.assertTrue(repr(p).startswith("Point("))
+
+    def test_edge(self):
+        e = grids.Edge(grids.Point(0, 0), grids.Point(2, 4))
+        self.assertEqual(e.at(0.5), grids.Point(1, 2))
+        self.assertEqual(e, grids.Edge(e.start, e.stop))
+
+    def test_hexagon(self):
+        h = grids.Hexagon(1, 2)
+        self.assertEqual((h.a, h.b), (1, 2))
+        self.assertEqual(h + grids.Hexagon(1, 1), grids.Hexagon(2, 3))
+        self.assertEqual(h - h, grids.Hexagon())
+        self.assertEqual(2*h, grids.Hexagon(2, 4))
+        self.assertEqual(-h, grids.Hexagon(-1, -2))
+        self.assertEqual(repr(h), "Hexagon(1, 2)")
+        p = h.to_point()
+        self.assertAlmostEqual(p.x, 0)
+        self.assertAlmostEqual(p.y, math.sqrt(3))
+        self.assertEqual(len(h.corners()), 6)
+        self.assertEqual(len(h.edges()), 6)
+        self.assertEqual(len(h.wedges()), 6)
+        # Usable as dictionary keys
+        self.assertEqual(len({h, grids.Hexagon(1, 2), grids.Hexagon()}), 2)
+
+    def test_free_functions(self):
+        self.assertEqual(len(grids.neighbor_directions), 6)
+        for direction in grids.neighbor_directions:
+            self.assertEqual(grids.manhattan_distance(direction), 1)
+        h = grids.Hexagon(3, 1)
+        self.assertEqual(grids.rotate_clockwise(grids.rotate(h)), h)
+        self.assertEqual(grids.nearest_hex(h.to_point()), h)
+        self.assertEqual(len(grids.ring(grids.Hexagon(), 2)), 12)
+        self.assertEqual(len(grids.spiral(grids.Hexagon(), 2)), 19)
+
+
+class BatchTest(unittest.TestCase):
+    def setUp(self):
+        rng = np.random.default_rng(1)
+        self.points = rng.uniform(-50, 50, size=(1000, 2))
+
+    def test_nearest_hex(self):
+        hexes = grids.nearest_hex(self.points, num_threads=4)
+        self.assertEqual(hexes.dtype, np.int32)
+        self.assertEqual(hexes.shape, (1000, 2))
+        for point, hex in zip(self.points[:50], hexes[:50]):
+            expected = grids.nearest_hex(grids.Point(*point))
+            self.assertEqual((hex[0], hex[1]), (expected.a, expected.b))
+
+    def test_to_point_round_trip(self):
+        hexes = grids.nearest_hex(self.points)
+        centers = grids.to_point(hexes, num_threads=3)
+        self.assertEqual(centers.dtype, np.float64)
+        self.assertEqual(centers.shape, (1000, 2))
+        np.testing.assert_array_equal(grids.nearest_hex(centers), hexes)
+
+    def test_manhattan_distance(self):
+        hexes = grids.nearest_hex(self.points)
+        distances = grids.manhattan_distance(hexes)
+        self.assertEqual(distances.shape, (1000,))
+        for hex, distance in zip(hexes[:50], distances[:50]):
+            hexagon = grids.Hexagon(int(hex[0]), int(hex[1]))
+            self.assertEqual(distance, grids.manhattan_distance(hexagon))
+
+    def test_ring_and_spiral(self):
+        centers = np.array([[0, 0], [5, -3]], dtype=np.int32)
+        for function, size in ((grids.ring, 12), (grids.spiral, 19)):
+            res = function(centers, 2, num_threads=2)
+            self.assertEqual(res.shape, (2, size, 2))
+            for center, hexes in zip(centers, res):
+                hexagon = grids.Hexagon(int(center[0]), int(center[1]))
+                expected = function(hexagon, 2)
+                self.assertEqual([(h[0], h[1]) for h in hexes],
+                                 [(h.a, h.b) for h in expected])
+
+    def test_conversions(self):
+        # Lists and other dtypes are converted by NumPy.
+        hexes = grids.nearest_hex([[0.0, 0.0], [1.0, 0.0]])
+        np.testing.assert_array_equal(hexes, [[0, 0], [1, 0]])
+        np.testing.assert_array_equal(
+            grids.manhattan_distance(np.array([[2, 1]], dtype=np.int64)), [2])
+
+    def test_bad_shape(self):
+        with self.assertRaises(ValueError):
+            grids.nearest_hex(np.zeros((4, 3)))
+        with self.assertRaises(ValueError):
+            grids.to_point(np.zeros(4, dtype=np.int32))
+
+
+if __name__ == "__main__":
+    unittest.main()